@@ -2,11 +2,21 @@
 // Created by Jean-Edouard BOULANGER on 28/12/2020.
 //
 
+#define _GNU_SOURCE
+
 #include "cjson_allocator.h"
 #include "cjson_utils.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef CJSON_MAPPED_ARENA_COMMIT_STEP
+#define CJSON_MAPPED_ARENA_COMMIT_STEP (32 * 1024 * 1024)
+#endif
+
+#define CJSON_HUGE_PAGE_SIZE (2 * 1024 * 1024)
 
 
 void* cjson_default_alloc(CJSON_UNUSED void* context, size_t size) {
@@ -21,60 +31,119 @@ void cjson_default_dealloc(CJSON_UNUSED void* context, void* address) {
     free(address);
 }
 
-typedef struct CJsonLinearAllocatorContext {
-    void* pool;
-    void* head;
-    size_t size;
-    size_t capacity;
-} CJsonLinearAllocatorContext;
-
-typedef struct CJsonLinearAllocatorBlockHeader {
-    void* start_ptr;
-    void* end_ptr;
-} CJsonLinearAllocatorBlockHeader;
-
 CJsonLinearAllocatorContext* cjson_linear_allocator_context_new(size_t pool_size) {
     CJsonLinearAllocatorContext* this = (CJsonLinearAllocatorContext*) malloc(sizeof(CJsonLinearAllocatorContext));
-    this->pool = malloc(pool_size);
+    this->pool = (char*) malloc(pool_size);
     this->head = this->pool;
     this->size = 0;
     this->capacity = pool_size;
+    this->mapped = false;
+    this->reserved = pool_size;
+    this->commit_step = 0;
+    this->flags = cjson_mapped_arena_no_flags;
     return this;
 }
 
+size_t cjson_impl_round_up(size_t size, size_t multiple) {
+    return ((size + multiple - 1) / multiple) * multiple;
+}
+
+size_t cjson_impl_mapped_arena_granularity(unsigned int flags) {
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    if(flags & (cjson_mapped_arena_huge_pages | cjson_mapped_arena_hugetlb)) {
+        return CJSON_MAX(page_size, (size_t) CJSON_HUGE_PAGE_SIZE);
+    }
+    return page_size;
+}
+
+CJsonLinearAllocatorContext* cjson_mapped_linear_allocator_context_new(size_t reserve_size, size_t commit_step, unsigned int flags) {
+    const size_t granularity = cjson_impl_mapped_arena_granularity(flags);
+    reserve_size = cjson_impl_round_up(reserve_size, granularity);
+    commit_step = cjson_impl_round_up(commit_step == 0 ? CJSON_MAPPED_ARENA_COMMIT_STEP : commit_step, granularity);
+    // Over-reserve by one granule so that the pool can start on a huge page boundary.
+    const size_t mapping_size = reserve_size + granularity;
+    char* mapping = (char*) mmap(NULL, mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(mapping == MAP_FAILED) { return NULL; }
+    char* pool = (char*) cjson_impl_round_up((size_t) mapping, granularity);
+    if(pool != mapping) { munmap(mapping, pool - mapping); }
+    munmap(pool + reserve_size, (mapping + mapping_size) - (pool + reserve_size));
+
+    CJsonLinearAllocatorContext* this = (CJsonLinearAllocatorContext*) malloc(sizeof(CJsonLinearAllocatorContext));
+    this->pool = pool;
+    this->head = this->pool;
+    this->size = 0;
+    this->capacity = 0;
+    this->mapped = true;
+    this->reserved = reserve_size;
+    this->commit_step = commit_step;
+    this->flags = flags;
+    return this;
+}
+
+bool cjson_impl_mapped_arena_commit(CJsonLinearAllocatorContext* this, size_t bytes) {
+    char* start = this->pool + this->capacity;
+    const int base_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED
+        | ((this->flags & cjson_mapped_arena_populate) ? MAP_POPULATE : 0);
+    if(this->flags & cjson_mapped_arena_hugetlb) {
+        void* committed = mmap(start, bytes, PROT_READ | PROT_WRITE, base_flags | MAP_HUGETLB, -1, 0);
+        if(committed != MAP_FAILED) { return true; }
+        // No huge pages reserved on the system: carry on with regular pages from now on.
+        this->flags &= ~cjson_mapped_arena_hugetlb;
+        this->flags |= cjson_mapped_arena_huge_pages;
+    }
+    void* committed = mmap(start, bytes, PROT_READ | PROT_WRITE, base_flags, -1, 0);
+    if(committed == MAP_FAILED) { return false; }
+    if(this->flags & cjson_mapped_arena_huge_pages) {
+        madvise(start, bytes, MADV_HUGEPAGE);
+    }
+    return true;
+}
+
+bool cjson_impl_linear_allocator_grow(CJsonLinearAllocatorContext* this, size_t min_free_bytes) {
+    if(!this->mapped) { return false; }
+    const size_t missing_bytes = min_free_bytes - (this->capacity - this->size);
+    const size_t commit_size = CJSON_MIN(
+        cjson_impl_round_up(missing_bytes, this->commit_step),
+        this->reserved - this->capacity);
+    if(commit_size < missing_bytes) { return false; }
+    if(!cjson_impl_mapped_arena_commit(this, commit_size)) { return false; }
+    this->capacity += commit_size;
+    return true;
+}
+
 void cjson_linear_allocator_context_free(CJsonLinearAllocatorContext* this) {
-    free(this->pool);
+    if(this->mapped) {
+        munmap(this->pool, this->reserved);
+    }
+    else {
+        free(this->pool);
+    }
     free(this);
 }
 
 void* cjson_linear_allocator_alloc(void* context, size_t size) {
-    CJsonLinearAllocatorContext* this = (CJsonLinearAllocatorContext*) context;
-    const size_t block_size = sizeof(CJsonLinearAllocatorBlockHeader) + size;
-    if(block_size > (this->capacity - this->size)) { return NULL; }
-    void* header_ptr = this->head;
-    void* alloc_ptr = header_ptr + sizeof(CJsonLinearAllocatorBlockHeader);
-    CJsonLinearAllocatorBlockHeader* block_header = (CJsonLinearAllocatorBlockHeader*) header_ptr;
-    block_header->start_ptr = alloc_ptr;
-    block_header->end_ptr = alloc_ptr + size;
-    this->head += block_size;
-    return alloc_ptr;
+    return cjson_impl_linear_allocator_bump((CJsonLinearAllocatorContext*) context, size);
 }
 
 void cjson_linear_allocator_dealloc(CJSON_UNUSED void* context, CJSON_UNUSED void* address) {}
 
 void* cjson_linear_allocator_realloc(void* context, void* address, size_t new_size) {
     CJsonLinearAllocatorContext* this = (CJsonLinearAllocatorContext*) context;
-    CJsonLinearAllocatorBlockHeader* header_ptr = address - sizeof(CJsonLinearAllocatorBlockHeader);
+    CJsonLinearAllocatorBlockHeader* header_ptr = ((CJsonLinearAllocatorBlockHeader*) address) - 1;
     const size_t previous_size = header_ptr->end_ptr - header_ptr->start_ptr;
-    if(new_size < previous_size) { return header_ptr->start_ptr; }
+    if(new_size <= previous_size) { return header_ptr->start_ptr; }
     else if(this->head == header_ptr->end_ptr) {
-        const size_t deficit = new_size - previous_size;
-        if(this->capacity < deficit) { return NULL; }
-        this->head += (new_size - previous_size);
+        const size_t deficit = cjson_impl_linear_allocator_align(new_size) - previous_size;
+        if(deficit > (this->capacity - this->size) && !cjson_impl_linear_allocator_grow(this, deficit)) {
+            return NULL;
+        }
+        this->head += deficit;
+        this->size += deficit;
         header_ptr->end_ptr = this->head;
         return header_ptr->start_ptr;
     }
-    void* new_ptr = cjson_linear_allocator_alloc(context, new_size);
+    void* new_ptr = cjson_impl_linear_allocator_bump(this, new_size);
+    if(new_ptr == NULL) { return NULL; }
     memcpy(new_ptr, header_ptr->start_ptr, previous_size);
     return new_ptr;
 }
@@ -85,6 +154,21 @@ CJsonAllocator* cjson_linear_allocator_new(size_t size) {
     allocator->dealloc = cjson_linear_allocator_dealloc;
     allocator->realloc = cjson_linear_allocator_realloc;
     allocator->context = cjson_linear_allocator_context_new(size);
+    allocator->traits = cjson_allocator_bulk_free_trait;
+    allocator->alloc_kind = NULL;
+    return allocator;
+}
+
+CJsonAllocator* cjson_mapped_linear_allocator_new(size_t reserve_size, size_t commit_step, unsigned int flags) {
+    CJsonLinearAllocatorContext* context = cjson_mapped_linear_allocator_context_new(reserve_size, commit_step, flags);
+    if(context == NULL) { return NULL; }
+    CJsonAllocator* allocator = (CJsonAllocator*) malloc(sizeof(CJsonAllocator));
+    allocator->alloc = cjson_linear_allocator_alloc;
+    allocator->dealloc = cjson_linear_allocator_dealloc;
+    allocator->realloc = cjson_linear_allocator_realloc;
+    allocator->context = context;
+    allocator->traits = cjson_allocator_bulk_free_trait;
+    allocator->alloc_kind = NULL;
     return allocator;
 }
 
@@ -93,12 +177,20 @@ void cjson_linear_allocator_free(CJsonAllocator* allocator) {
     free(allocator);
 }
 
+void cjson_linear_allocator_reset(CJsonAllocator* allocator) {
+    CJsonLinearAllocatorContext* context = (CJsonLinearAllocatorContext*) allocator->context;
+    context->head = context->pool;
+    context->size = 0;
+}
+
 CJsonAllocator* cjson_allocator_get_default() {
     static CJsonAllocator s_allocator = {
         .alloc = cjson_default_alloc,
         .realloc = cjson_default_realloc,
         .dealloc = cjson_default_dealloc,
-        .context = NULL
+        .context = NULL,
+        .traits = cjson_allocator_no_traits,
+        .alloc_kind = NULL
     };
     return &s_allocator;
 }
@@ -108,17 +200,33 @@ CJsonAllocator* cjson_allocator_or_default(CJsonAllocator* allocator) {
     return allocator;
 }
 
-void* cjson_alloc(CJsonAllocator* this, size_t size) {
+bool cjson_allocator_has_trait(const CJsonAllocator* this, CJsonAllocatorTraits trait) {
+    if(this == NULL) { this = cjson_allocator_get_default(); }
+    return (this->traits & trait) != 0;
+}
+
+bool cjson_allocator_has_bulk_free(const CJsonAllocator* this) {
+    return cjson_allocator_has_trait(this, cjson_allocator_bulk_free_trait);
+}
+
+void* (cjson_alloc)(CJsonAllocator* this, size_t size) {
+    return cjson_alloc_kind(this, size, cjson_other_allocation);
+}
+
+void* (cjson_alloc_kind)(CJsonAllocator* this, size_t size, CJsonAllocationKind kind) {
     this = cjson_allocator_or_default(this);
+    if(this->alloc_kind != NULL) {
+        return this->alloc_kind(this->context, size, kind);
+    }
     return this->alloc(this->context, size);
 }
 
-void* cjson_realloc(CJsonAllocator* this, void* address, size_t size) {
+void* (cjson_realloc)(CJsonAllocator* this, void* address, size_t size) {
     this = cjson_allocator_or_default(this);
     return this->realloc(this->context, address, size);
 }
 
-void cjson_dealloc(CJsonAllocator* this, void* address) {
+void (cjson_dealloc)(CJsonAllocator* this, void* address) {
     this = cjson_allocator_or_default(this);
     this->dealloc(this->context, address);
 }
@@ -0,0 +1,181 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_allocator.h"
+#include "cjson_allocator_stats.h"
+#include "cjson_assert.h"
+#include "cjson_stringstream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+const char* const ALLOCATION_KIND_NAMES[] = {
+    "other",
+    "value",
+    "object",
+    "object_node",
+    "key",
+    "str",
+    "array",
+    "array_buffer",
+    "stream_block",
+    "buffer",
+    "reader"
+};
+
+CJSON_STATIC_ASSERT(sizeof(ALLOCATION_KIND_NAMES) / sizeof(ALLOCATION_KIND_NAMES[0]) == cjson_allocation_kind_count);
+
+typedef struct CJsonStatsAllocatorContext {
+    CJsonAllocator* inner;
+    CJsonAllocatorStats stats;
+} CJsonStatsAllocatorContext;
+
+// Prepended to every allocation so that realloc and dealloc know what they release.
+typedef struct CJsonStatsBlockHeader {
+    size_t size;
+    size_t kind;
+} CJsonStatsBlockHeader;
+
+void cjson_stats_record_alloc(CJsonAllocatorStats* this, CJsonAllocationKind kind, size_t size) {
+    CJsonAllocationCounters* counters = &this->by_kind[kind];
+    counters->allocs += 1;
+    counters->allocated_bytes += size;
+    counters->live_bytes += size;
+    this->total.allocs += 1;
+    this->total.allocated_bytes += size;
+    this->total.live_bytes += size;
+    if(this->total.live_bytes > this->peak_bytes) {
+        this->peak_bytes = this->total.live_bytes;
+    }
+}
+
+void cjson_stats_record_realloc(CJsonAllocatorStats* this, CJsonAllocationKind kind, size_t old_size, size_t new_size) {
+    CJsonAllocationCounters* counters = &this->by_kind[kind];
+    counters->reallocs += 1;
+    counters->allocated_bytes += new_size;
+    counters->live_bytes = counters->live_bytes - old_size + new_size;
+    this->total.reallocs += 1;
+    this->total.allocated_bytes += new_size;
+    this->total.live_bytes = this->total.live_bytes - old_size + new_size;
+    if(this->total.live_bytes > this->peak_bytes) {
+        this->peak_bytes = this->total.live_bytes;
+    }
+}
+
+void cjson_stats_record_dealloc(CJsonAllocatorStats* this, CJsonAllocationKind kind, size_t size) {
+    CJsonAllocationCounters* counters = &this->by_kind[kind];
+    counters->deallocs += 1;
+    counters->live_bytes -= size;
+    this->total.deallocs += 1;
+    this->total.live_bytes -= size;
+}
+
+void* cjson_stats_allocator_alloc_kind(void* context, size_t size, CJsonAllocationKind kind) {
+    CJsonStatsAllocatorContext* this = (CJsonStatsAllocatorContext*) context;
+    CJsonStatsBlockHeader* header = (CJsonStatsBlockHeader*) cjson_alloc_kind(
+        this->inner, sizeof(CJsonStatsBlockHeader) + size, kind);
+    if(header == NULL) { return NULL; }
+    header->size = size;
+    header->kind = kind;
+    cjson_stats_record_alloc(&this->stats, kind, size);
+    return header + 1;
+}
+
+void* cjson_stats_allocator_alloc(void* context, size_t size) {
+    return cjson_stats_allocator_alloc_kind(context, size, cjson_other_allocation);
+}
+
+void* cjson_stats_allocator_realloc(void* context, void* address, size_t size) {
+    if(address == NULL) { return cjson_stats_allocator_alloc(context, size); }
+    CJsonStatsAllocatorContext* this = (CJsonStatsAllocatorContext*) context;
+    CJsonStatsBlockHeader* header = ((CJsonStatsBlockHeader*) address) - 1;
+    const size_t old_size = header->size;
+    const CJsonAllocationKind kind = (CJsonAllocationKind) header->kind;
+    header = (CJsonStatsBlockHeader*) cjson_realloc(this->inner, header, sizeof(CJsonStatsBlockHeader) + size);
+    if(header == NULL) { return NULL; }
+    header->size = size;
+    cjson_stats_record_realloc(&this->stats, kind, old_size, size);
+    return header + 1;
+}
+
+void cjson_stats_allocator_dealloc(void* context, void* address) {
+    if(address == NULL) { return; }
+    CJsonStatsAllocatorContext* this = (CJsonStatsAllocatorContext*) context;
+    CJsonStatsBlockHeader* header = ((CJsonStatsBlockHeader*) address) - 1;
+    cjson_stats_record_dealloc(&this->stats, (CJsonAllocationKind) header->kind, header->size);
+    cjson_dealloc(this->inner, header);
+}
+
+CJsonAllocator* cjson_stats_allocator_new(CJsonAllocator* inner) {
+    inner = cjson_allocator_or_default(inner);
+    CJsonAllocator* allocator = (CJsonAllocator*) malloc(sizeof(CJsonAllocator));
+    CJsonStatsAllocatorContext* context = (CJsonStatsAllocatorContext*) malloc(sizeof(CJsonStatsAllocatorContext));
+    context->inner = inner;
+    memset(&context->stats, 0, sizeof(CJsonAllocatorStats));
+    allocator->alloc = cjson_stats_allocator_alloc;
+    allocator->realloc = cjson_stats_allocator_realloc;
+    allocator->dealloc = cjson_stats_allocator_dealloc;
+    allocator->alloc_kind = cjson_stats_allocator_alloc_kind;
+    allocator->context = context;
+    allocator->traits = inner->traits;
+    return allocator;
+}
+
+void cjson_stats_allocator_free(CJsonAllocator* allocator) {
+    CJSON_CONTRACT(cjson_allocator_stats(allocator) != NULL);
+    free(allocator->context);
+    free(allocator);
+}
+
+const CJsonAllocatorStats* cjson_allocator_stats(const CJsonAllocator* allocator) {
+    if(allocator == NULL || allocator->alloc_kind != cjson_stats_allocator_alloc_kind) {
+        return NULL;
+    }
+    return &((CJsonStatsAllocatorContext*) allocator->context)->stats;
+}
+
+void cjson_allocation_counters_reset(CJsonAllocationCounters* this) {
+    this->allocs = 0;
+    this->reallocs = 0;
+    this->deallocs = 0;
+    this->allocated_bytes = 0;
+}
+
+void cjson_allocator_stats_reset(CJsonAllocator* allocator) {
+    CJSON_CONTRACT(cjson_allocator_stats(allocator) != NULL);
+    CJsonAllocatorStats* stats = &((CJsonStatsAllocatorContext*) allocator->context)->stats;
+    // Live bytes describe outstanding allocations and survive the reset.
+    cjson_allocation_counters_reset(&stats->total);
+    for(size_t kind = 0; kind != cjson_allocation_kind_count; ++kind) {
+        cjson_allocation_counters_reset(&stats->by_kind[kind]);
+    }
+    stats->peak_bytes = stats->total.live_bytes;
+}
+
+const char* cjson_allocation_kind_name(CJsonAllocationKind kind) {
+    CJSON_CONTRACT(kind < cjson_allocation_kind_count);
+    return ALLOCATION_KIND_NAMES[kind];
+}
+
+void cjson_allocation_counters_fmt(CJsonStringStream* stream, const char* name, const CJsonAllocationCounters* counters) {
+    char line[256];
+    snprintf(line, sizeof(line), "%s: allocs=%zu reallocs=%zu deallocs=%zu allocated_bytes=%zu live_bytes=%zu\n",
+             name, counters->allocs, counters->reallocs, counters->deallocs,
+             counters->allocated_bytes, counters->live_bytes);
+    cjson_string_stream_write(stream, line);
+}
+
+void cjson_allocator_stats_fmt(CJsonStringStream* stream, const CJsonAllocatorStats* stats) {
+    char line[64];
+    cjson_allocation_counters_fmt(stream, "total", &stats->total);
+    snprintf(line, sizeof(line), "peak_bytes=%zu\n", stats->peak_bytes);
+    cjson_string_stream_write(stream, line);
+    for(size_t kind = 0; kind != cjson_allocation_kind_count; ++kind) {
+        const CJsonAllocationCounters* counters = &stats->by_kind[kind];
+        if(counters->allocs == 0 && counters->reallocs == 0) { continue; }
+        cjson_allocation_counters_fmt(stream, ALLOCATION_KIND_NAMES[kind], counters);
+    }
+}
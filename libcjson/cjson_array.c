@@ -10,6 +10,7 @@
 #include "cjson_value.h"
 #include "cjson_assert.h"
 #include "cjson_allocator.h"
+#include "cjson_writer.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -20,13 +21,17 @@ const size_t k_default_capacity = 8;
 const size_t k_capacity_growth_factor = 2;
 
 CJsonArray* cjson_array_new(CJsonAllocator* allocator) {
+    return cjson_array_new_with_capacity(k_default_capacity, allocator);
+}
+
+CJsonArray* cjson_array_new_with_capacity(size_t capacity, CJsonAllocator* allocator) {
     allocator = cjson_allocator_or_default(allocator);
-    CJsonArray* array = (CJsonArray*) cjson_alloc(allocator, sizeof(CJsonArray));
+    CJsonArray* array = (CJsonArray*) cjson_alloc_kind(allocator, sizeof(CJsonArray), cjson_array_allocation);
     if(array == NULL) { return NULL; }
     array->_allocator = allocator;
     array->_size = 0;
-    array->_capacity = k_default_capacity;
-    array->_data = (CJsonValue**) cjson_alloc(allocator, array->_capacity * sizeof(CJsonValue*));
+    array->_capacity = CJSON_MAX(capacity, 1);
+    array->_data = (CJsonValue**) cjson_alloc_kind(allocator, array->_capacity * sizeof(CJsonValue*), cjson_array_buffer_allocation);
     if(array->_data == NULL) {
         cjson_dealloc(allocator, array);
         return NULL;
@@ -35,19 +40,28 @@ CJsonArray* cjson_array_new(CJsonAllocator* allocator) {
 }
 
 void cjson_array_free(CJsonArray* this) {
-    cjson_array_clear(this);
+    CJsonImplValueStack pending;
+    cjson_impl_value_stack_init(&pending);
+    cjson_impl_array_free_deferred(this, &pending);
+    cjson_impl_value_stack_drain(&pending);
+}
+
+void cjson_impl_array_free_deferred(CJsonArray* this, CJsonImplValueStack* pending) {
+    for(size_t i = 0; i < this->_size; ++i) {
+        cjson_impl_value_free_deferred(this->_data[i], pending);
+    }
     cjson_dealloc(this->_allocator, this->_data);
     cjson_dealloc(this->_allocator, this);
 }
 
 CJsonArray* cjson_array_copy(CJsonArray* this) {
-    CJsonArray* array = (CJsonArray*) cjson_alloc(this->_allocator, sizeof(CJsonArray));
+    CJsonArray* array = (CJsonArray*) cjson_alloc_kind(this->_allocator, sizeof(CJsonArray), cjson_array_allocation);
     if(array == NULL) {
         return NULL;
     }
     array->_size = this->_size;
     array->_capacity = this->_capacity;
-    array->_data = (CJsonValue**)cjson_alloc(this->_allocator, array->_capacity * sizeof(CJsonValue*));
+    array->_data = (CJsonValue**)cjson_alloc_kind(this->_allocator, array->_capacity * sizeof(CJsonValue*), cjson_array_buffer_allocation);
     if(array->_data == NULL) {
         cjson_dealloc(this->_allocator, array);
         return NULL;
@@ -96,9 +110,12 @@ CJsonValue* cjson_array_back(CJsonArray* this) {
 }
 
 void cjson_array_clear(CJsonArray* this) {
+    CJsonImplValueStack pending;
+    cjson_impl_value_stack_init(&pending);
     for(size_t i = 0; i < this->_size; ++i) {
-        cjson_value_free(this->_data[i]);
+        cjson_impl_value_free_deferred(this->_data[i], &pending);
     }
+    cjson_impl_value_stack_drain(&pending);
     this->_size = 0;
 }
 
@@ -158,14 +175,10 @@ void cjson_array_pop(CJsonArray* this) {
 }
 
 void cjson_array_fmt(CJsonStringStream* stream, CJsonArray* this) {
-    cjson_string_stream_write(stream, "[");
-    for(size_t i = 0; i != this->_size; ++i) {
-        cjson_value_fmt(stream, this->_data[i]);
-        if(i < this->_size - 1) {
-            cjson_string_stream_write(stream, ", ");
-        }
-    }
-    cjson_string_stream_write(stream, "]");
+    CJsonSink sink;
+    cjson_string_stream_sink_init(&sink, stream);
+    const CJsonWriteOptions options = cjson_write_options_default();
+    cjson_impl_write_array(&sink, this, &options, 0);
 }
 
 CJsonArray* cjson_impl_array_builder(CJsonAllocator* allocator, size_t items, ...) {
@@ -0,0 +1,207 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_array_stream.h"
+#include "cjson_allocator.h"
+#include "cjson_buffer.h"
+#include "cjson_cursor.h"
+#include "cjson_parser.h"
+#include "cjson_tokenizer.h"
+#include "cjson_utils.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef CJSON_ARRAY_STREAM_WINDOW_SIZE
+#define CJSON_ARRAY_STREAM_WINDOW_SIZE ((size_t) 1 << 16)
+#endif
+
+
+typedef enum CJsonArrayStreamState {
+    cjson_array_stream_opening_state = 0,
+    cjson_array_stream_element_state,
+    cjson_array_stream_done_state,
+    cjson_array_stream_failed_state
+} CJsonArrayStreamState;
+
+typedef struct CJsonImplArrayStream {
+    // Bytes [position, size) of the window are yet to be read. Windows over a file live in
+    // `buffer`, windows over a buffer are the buffer itself.
+    const char* window;
+    size_t size;
+    size_t position;
+    CJsonBuffer* buffer;
+    size_t read_size;
+    int fd;
+    bool at_eof;
+    CJsonArrayStreamState state;
+    CJsonAllocator* arena;
+    CJsonParser* parser;
+} CJsonImplArrayStream;
+
+// Reads more of the file into the window, keeping the bytes yet to be read, until the window is
+// full: an element which does not fit is then scanned again in a window twice as large. Returns
+// false when nothing was left to read or on a read error.
+bool cjson_impl_array_stream_refill(CJsonImplArrayStream* this) {
+    if(this->at_eof) { return false; }
+    const size_t pending = this->size - this->position;
+    memmove(this->buffer->buffer, this->buffer->buffer + this->position, pending);
+    this->position = 0;
+    this->size = pending;
+    if(this->buffer->size - pending < this->read_size) {
+        cjson_buffer_resize(this->buffer, CJSON_MAX(this->buffer->size * 2, pending + this->read_size));
+    }
+    this->window = this->buffer->buffer;
+    while(this->size < this->buffer->size) {
+        const ssize_t read_size = read(this->fd, this->buffer->buffer + this->size, this->buffer->size - this->size);
+        if(read_size < 0 && errno == EINTR) { continue; }
+        if(read_size < 0) {
+            this->state = cjson_array_stream_failed_state;
+            this->at_eof = true;
+            return false;
+        }
+        if(read_size == 0) {
+            this->at_eof = true;
+            break;
+        }
+        this->size += read_size;
+    }
+    return this->size > pending;
+}
+
+// Next byte which is not blank, '\0' at the end of the input.
+char cjson_impl_array_stream_peek(CJsonImplArrayStream* this) {
+    for(;;) {
+        const char* end = this->window + this->size;
+        const char* cursor = cjson_tokenizer_skip_blank(this->window + this->position, end);
+        this->position = cursor - this->window;
+        if(cursor != end) { return *cursor; }
+        if(!cjson_impl_array_stream_refill(this)) { return '\0'; }
+    }
+}
+
+bool cjson_impl_array_stream_fail(CJsonImplArrayStream* this) {
+    this->state = cjson_array_stream_failed_state;
+    return false;
+}
+
+// Only blanks may follow the array.
+bool cjson_impl_array_stream_close_array(CJsonImplArrayStream* this) {
+    ++this->position;
+    if(cjson_impl_array_stream_peek(this) != '\0' || this->state == cjson_array_stream_failed_state) {
+        return cjson_impl_array_stream_fail(this);
+    }
+    this->state = cjson_array_stream_done_state;
+    return false;
+}
+
+bool cjson_impl_array_stream_next(CJsonImplArrayStream* this, CJsonValue** value) {
+    switch(this->state) {
+        case cjson_array_stream_opening_state: {
+            if(cjson_impl_array_stream_peek(this) != '[') { return cjson_impl_array_stream_fail(this); }
+            ++this->position;
+            if(cjson_impl_array_stream_peek(this) == ']') { return cjson_impl_array_stream_close_array(this); }
+            break;
+        }
+        case cjson_array_stream_element_state: {
+            const char separator = cjson_impl_array_stream_peek(this);
+            if(separator == ']') { return cjson_impl_array_stream_close_array(this); }
+            if(separator != ',') { return cjson_impl_array_stream_fail(this); }
+            ++this->position;
+            break;
+        }
+        case cjson_array_stream_done_state:
+        case cjson_array_stream_failed_state: return false;
+    }
+    if(cjson_impl_array_stream_peek(this) == '\0') { return cjson_impl_array_stream_fail(this); }
+    // The element is complete once a byte follows it in the window.
+    const char* element_end = NULL;
+    for(;;) {
+        const char* end = this->window + this->size;
+        element_end = cjson_impl_cursor_skip_value(this->window + this->position, end);
+        if(element_end != NULL && element_end != end) { break; }
+        if(!cjson_impl_array_stream_refill(this)) { return cjson_impl_array_stream_fail(this); }
+    }
+    const char* element = this->window + this->position;
+    cjson_parser_reset(this->parser, this->arena);
+    cjson_linear_allocator_reset(this->arena);
+    *value = cjson_parser_read(this->parser, element, element_end - element);
+    if(*value == NULL) { return cjson_impl_array_stream_fail(this); }
+    this->position = element_end - this->window;
+    this->state = cjson_array_stream_element_state;
+    return true;
+}
+
+CJsonImplArrayStream* cjson_impl_array_stream_new(const CJsonArrayStreamOptions* options) {
+    CJsonImplArrayStream* this = (CJsonImplArrayStream*) cjson_alloc_kind(NULL, sizeof(CJsonImplArrayStream), cjson_reader_allocation);
+    this->window = NULL;
+    this->size = 0;
+    this->position = 0;
+    this->buffer = NULL;
+    this->read_size = CJSON_MAX(options->window_size, 1);
+    this->fd = -1;
+    this->at_eof = true;
+    this->state = cjson_array_stream_opening_state;
+    this->arena = cjson_mapped_linear_allocator_new(CJSON_ARENA_RESERVE, 0, cjson_mapped_arena_no_flags);
+    this->parser = cjson_parser_new(NULL);
+    cjson_parser_set_max_depth(this->parser, options->max_depth);
+    return this;
+}
+
+void cjson_impl_array_stream_free(CJsonImplArrayStream* this) {
+    cjson_parser_free(this->parser);
+    cjson_linear_allocator_free(this->arena);
+    if(this->buffer != NULL) {
+        cjson_buffer_free(this->buffer);
+    }
+    cjson_dealloc(NULL, this);
+}
+
+CJsonArrayStreamOptions cjson_array_stream_options_default() {
+    const CJsonArrayStreamOptions options = {
+        .window_size = CJSON_ARRAY_STREAM_WINDOW_SIZE,
+        .max_depth = 0
+    };
+    return options;
+}
+
+CJsonArrayStream* cjson_impl_array_stream_wrap(CJsonImplArrayStream* impl) {
+    CJsonArrayStream* this = (CJsonArrayStream*) cjson_alloc_kind(NULL, sizeof(CJsonArrayStream), cjson_reader_allocation);
+    this->_impl = impl;
+    return this;
+}
+
+CJsonArrayStream* cjson_array_stream_open_fd(int fd, const CJsonArrayStreamOptions* options) {
+    const CJsonArrayStreamOptions default_options = cjson_array_stream_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonImplArrayStream* impl = cjson_impl_array_stream_new(options);
+    impl->buffer = cjson_buffer_new(impl->read_size, NULL);
+    impl->window = impl->buffer->buffer;
+    impl->fd = fd;
+    impl->at_eof = false;
+    return cjson_impl_array_stream_wrap(impl);
+}
+
+CJsonArrayStream* cjson_array_stream_open_buffer(const char* data, size_t size, const CJsonArrayStreamOptions* options) {
+    const CJsonArrayStreamOptions default_options = cjson_array_stream_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonImplArrayStream* impl = cjson_impl_array_stream_new(options);
+    impl->window = data;
+    impl->size = size;
+    return cjson_impl_array_stream_wrap(impl);
+}
+
+void cjson_array_stream_close(CJsonArrayStream* this) {
+    cjson_impl_array_stream_free(this->_impl);
+    cjson_dealloc(NULL, this);
+}
+
+bool cjson_array_stream_next(CJsonArrayStream* this, CJsonValue** value) {
+    return cjson_impl_array_stream_next(this->_impl, value);
+}
+
+bool cjson_array_stream_failed(const CJsonArrayStream* this) {
+    return this->_impl->state == cjson_array_stream_failed_state;
+}
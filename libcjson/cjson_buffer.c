@@ -9,9 +9,9 @@
 
 
 CJsonBuffer* cjson_buffer_new(size_t size, CJsonAllocator* allocator) {
-    CJsonBuffer* buffer = (CJsonBuffer*) cjson_alloc(allocator, sizeof(CJsonBuffer));
+    CJsonBuffer* buffer = (CJsonBuffer*) cjson_alloc_kind(allocator, sizeof(CJsonBuffer), cjson_buffer_allocation);
     buffer->size = size;
-    buffer->buffer = (char*) cjson_alloc(allocator, size * sizeof(char));
+    buffer->buffer = (char*) cjson_alloc_kind(allocator, size * sizeof(char), cjson_buffer_allocation);
     memset(buffer->buffer, 0, size * sizeof(char));
     buffer->_allocator = allocator;
     return buffer;
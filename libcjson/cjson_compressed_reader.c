@@ -0,0 +1,387 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_compressed_reader.h"
+#include "cjson_allocator.h"
+#include "cjson_parser.h"
+#include "cjson_utils.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef CJSON_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CJSON_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef CJSON_COMPRESSED_BLOCK_SIZE
+#define CJSON_COMPRESSED_BLOCK_SIZE ((size_t) 1 << 17)
+#endif
+
+#ifndef CJSON_COMPRESSED_BLOCK_COUNT
+#define CJSON_COMPRESSED_BLOCK_COUNT 4
+#endif
+
+// Compressed bytes read from a file at a time.
+#ifndef CJSON_COMPRESSED_READ_SIZE
+#define CJSON_COMPRESSED_READ_SIZE ((size_t) 1 << 16)
+#endif
+
+
+typedef struct CJsonDecompressor {
+    CJsonCompression compression;
+    // Compressed bytes yet to be decompressed. File input is read into `read_buffer`.
+    const unsigned char* input;
+    size_t input_size;
+    int fd;
+    unsigned char* read_buffer;
+    bool input_eof;
+    // The last gzip member or zstd frame is complete: the input may end here.
+    bool at_frame_end;
+#ifdef CJSON_ENABLE_ZLIB
+    z_stream zlib;
+    bool zlib_ready;
+#endif
+#ifdef CJSON_ENABLE_ZSTD
+    ZSTD_DStream* zstd;
+#endif
+} CJsonDecompressor;
+
+// Reads more of the file after the compressed bytes left. False on a read error.
+bool cjson_impl_decompressor_refill(CJsonDecompressor* this) {
+    if(this->input_eof) { return true; }
+    memmove(this->read_buffer, this->input, this->input_size);
+    this->input = this->read_buffer;
+    for(;;) {
+        const ssize_t read_size = read(this->fd, this->read_buffer + this->input_size, CJSON_COMPRESSED_READ_SIZE);
+        if(read_size < 0 && errno == EINTR) { continue; }
+        if(read_size < 0) { return false; }
+        if(read_size == 0) { this->input_eof = true; }
+        this->input_size += read_size;
+        return true;
+    }
+}
+
+CJsonCompression cjson_impl_compression_of(const unsigned char* data, size_t size) {
+    if(size >= 2 && data[0] == 0x1F && data[1] == 0x8B) { return cjson_gzip_compression; }
+    // zlib header: deflate method with a window of at most 32K, no preset dictionary, and a check
+    // value making the first two bytes a multiple of 31. Of the bytes it may start with, only '8'
+    // may start a JSON document as well, as in `80`: such input is taken as JSON.
+    if(size >= 2 && (data[0] & 0x0F) == 8 && (data[0] >> 4) <= 7 && (data[1] & 0x20) == 0
+       && ((data[0] << 8) | data[1]) % 31 == 0 && data[0] != '8') {
+        return cjson_gzip_compression;
+    }
+    if(size >= 4 && data[0] == 0x28 && data[1] == 0xB5 && data[2] == 0x2F && data[3] == 0xFD) { return cjson_zstd_compression; }
+    return cjson_no_compression;
+}
+
+// Resolves the compression from the first bytes of input and sets the decoder up. False when
+// the compression is not supported by this build.
+bool cjson_impl_decompressor_start(CJsonDecompressor* this) {
+    if(this->compression == cjson_auto_compression) {
+        while(this->input_size < 4 && !this->input_eof) {
+            if(!cjson_impl_decompressor_refill(this)) { return false; }
+        }
+        this->compression = cjson_impl_compression_of(this->input, this->input_size);
+    }
+    switch(this->compression) {
+        case cjson_auto_compression:
+        case cjson_no_compression: return true;
+        case cjson_gzip_compression: {
+#ifdef CJSON_ENABLE_ZLIB
+            memset(&this->zlib, 0, sizeof(z_stream));
+            // 32 lets zlib tell gzip from zlib headers.
+            this->zlib_ready = inflateInit2(&this->zlib, 15 + 32) == Z_OK;
+            return this->zlib_ready;
+#else
+            return false;
+#endif
+        }
+        case cjson_zstd_compression: {
+#ifdef CJSON_ENABLE_ZSTD
+            this->zstd = ZSTD_createDStream();
+            return this->zstd != NULL && !ZSTD_isError(ZSTD_initDStream(this->zstd));
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+void cjson_impl_decompressor_end(CJsonDecompressor* this) {
+#ifdef CJSON_ENABLE_ZLIB
+    if(this->zlib_ready) {
+        inflateEnd(&this->zlib);
+    }
+#endif
+#ifdef CJSON_ENABLE_ZSTD
+    if(this->zstd != NULL) {
+        ZSTD_freeDStream(this->zstd);
+    }
+#endif
+    cjson_dealloc(NULL, this->read_buffer);
+}
+
+// Decompresses the input on hand into `out`, adding to `produced`. False on malformed input.
+bool cjson_impl_decompressor_step(CJsonDecompressor* this, char* out, size_t capacity, size_t* produced) {
+    switch(this->compression) {
+        case cjson_auto_compression:
+        case cjson_no_compression: {
+            const size_t size = CJSON_MIN(this->input_size, capacity - *produced);
+            memcpy(out + *produced, this->input, size);
+            *produced += size;
+            this->input += size;
+            this->input_size -= size;
+            return true;
+        }
+        case cjson_gzip_compression: {
+#ifdef CJSON_ENABLE_ZLIB
+            if(this->at_frame_end) {
+                // Another member follows.
+                inflateReset(&this->zlib);
+                this->at_frame_end = false;
+            }
+            const size_t input_size = CJSON_MIN(this->input_size, (size_t) UINT32_MAX);
+            const size_t output_size = CJSON_MIN(capacity - *produced, (size_t) UINT32_MAX);
+            this->zlib.next_in = (Bytef*) this->input;
+            this->zlib.avail_in = (uInt) input_size;
+            this->zlib.next_out = (Bytef*) out + *produced;
+            this->zlib.avail_out = (uInt) output_size;
+            const int status = inflate(&this->zlib, Z_NO_FLUSH);
+            if(status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) { return false; }
+            this->input += input_size - this->zlib.avail_in;
+            this->input_size -= input_size - this->zlib.avail_in;
+            *produced += output_size - this->zlib.avail_out;
+            this->at_frame_end = status == Z_STREAM_END;
+            return true;
+#else
+            return false;
+#endif
+        }
+        case cjson_zstd_compression: {
+#ifdef CJSON_ENABLE_ZSTD
+            ZSTD_inBuffer input = {this->input, this->input_size, 0};
+            ZSTD_outBuffer output = {out + *produced, capacity - *produced, 0};
+            const size_t status = ZSTD_decompressStream(this->zstd, &output, &input);
+            if(ZSTD_isError(status)) { return false; }
+            this->input += input.pos;
+            this->input_size -= input.pos;
+            *produced += output.pos;
+            this->at_frame_end = status == 0;
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+// Fills `out` with up to `capacity` bytes of decompressed input, `produced` only being 0 at the
+// end of the input. False on a read error, or on malformed or truncated input.
+bool cjson_impl_decompressor_read(CJsonDecompressor* this, char* out, size_t capacity, size_t* produced) {
+    *produced = 0;
+    while(*produced < capacity) {
+        if(this->input_size == 0 && !this->input_eof && !cjson_impl_decompressor_refill(this)) { return false; }
+        if(this->input_size == 0 && this->input_eof) {
+            // Compressed streams may only end after a complete frame, unless they still hold
+            // buffered output.
+            const bool compressed = this->compression == cjson_gzip_compression || this->compression == cjson_zstd_compression;
+            if(!compressed || this->at_frame_end) { return true; }
+            const size_t before = *produced;
+            if(!cjson_impl_decompressor_step(this, out, capacity, produced)) { return false; }
+            if(*produced == before) { return this->at_frame_end; }
+            continue;
+        }
+        if(!cjson_impl_decompressor_step(this, out, capacity, produced)) { return false; }
+    }
+    return true;
+}
+
+// Decompressed blocks handed from the decompressing thread to the parsing one.
+typedef struct CJsonBlockQueue {
+    CJsonDecompressor* decompressor;
+    char** blocks;
+    size_t* sizes;
+    size_t block_size;
+    size_t count;
+    size_t head;
+    size_t filled;
+    bool done;
+    bool failed;
+    bool stopped;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} CJsonBlockQueue;
+
+void* cjson_impl_block_queue_producer_main(void* argument) {
+    CJsonBlockQueue* this = (CJsonBlockQueue*) argument;
+    for(;;) {
+        pthread_mutex_lock(&this->mutex);
+        while(this->filled == this->count && !this->stopped) {
+            pthread_cond_wait(&this->not_full, &this->mutex);
+        }
+        if(this->stopped) {
+            pthread_mutex_unlock(&this->mutex);
+            return NULL;
+        }
+        const size_t block = (this->head + this->filled) % this->count;
+        pthread_mutex_unlock(&this->mutex);
+
+        // The block is not in the queue yet: the parsing thread leaves it alone.
+        size_t produced = 0;
+        const bool read = cjson_impl_decompressor_read(this->decompressor, this->blocks[block], this->block_size, &produced);
+        pthread_mutex_lock(&this->mutex);
+        if(!read || produced == 0) {
+            this->done = true;
+            this->failed = !read;
+        } else {
+            this->sizes[block] = produced;
+            ++this->filled;
+        }
+        pthread_cond_signal(&this->not_empty);
+        pthread_mutex_unlock(&this->mutex);
+        if(!read || produced == 0) { return NULL; }
+    }
+}
+
+// Feeds the blocks of the queue to `parser` as they come. False when the input could not be
+// decompressed.
+bool cjson_impl_block_queue_parse(CJsonBlockQueue* this, CJsonParser* parser) {
+    pthread_t producer;
+    if(pthread_create(&producer, NULL, cjson_impl_block_queue_producer_main, this) != 0) { return false; }
+    for(;;) {
+        pthread_mutex_lock(&this->mutex);
+        while(this->filled == 0 && !this->done) {
+            pthread_cond_wait(&this->not_empty, &this->mutex);
+        }
+        if(this->filled == 0) {
+            pthread_mutex_unlock(&this->mutex);
+            break;
+        }
+        const size_t block = this->head;
+        pthread_mutex_unlock(&this->mutex);
+
+        const bool fed = cjson_parser_feed(parser, this->blocks[block], this->sizes[block]);
+        pthread_mutex_lock(&this->mutex);
+        this->head = (this->head + 1) % this->count;
+        --this->filled;
+        this->stopped = !fed;
+        pthread_cond_signal(&this->not_full);
+        pthread_mutex_unlock(&this->mutex);
+        if(!fed) { break; }
+    }
+    pthread_join(producer, NULL);
+    return !this->failed;
+}
+
+bool cjson_impl_compressed_parse_threaded(CJsonDecompressor* decompressor, const CJsonCompressedReadOptions* options, CJsonParser* parser) {
+    CJsonBlockQueue queue;
+    queue.decompressor = decompressor;
+    queue.block_size = CJSON_MAX(options->block_size, 1);
+    queue.count = CJSON_MAX(options->block_count, 1);
+    queue.blocks = (char**) cjson_alloc(NULL, queue.count * sizeof(char*));
+    queue.sizes = (size_t*) cjson_alloc(NULL, queue.count * sizeof(size_t));
+    for(size_t i = 0; i < queue.count; ++i) {
+        queue.blocks[i] = (char*) cjson_alloc(NULL, queue.block_size);
+    }
+    queue.head = 0;
+    queue.filled = 0;
+    queue.done = false;
+    queue.failed = false;
+    queue.stopped = false;
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+
+    const bool parsed = cjson_impl_block_queue_parse(&queue, parser);
+
+    pthread_cond_destroy(&queue.not_full);
+    pthread_cond_destroy(&queue.not_empty);
+    pthread_mutex_destroy(&queue.mutex);
+    for(size_t i = 0; i < queue.count; ++i) {
+        cjson_dealloc(NULL, queue.blocks[i]);
+    }
+    cjson_dealloc(NULL, queue.sizes);
+    cjson_dealloc(NULL, queue.blocks);
+    return parsed;
+}
+
+bool cjson_impl_compressed_parse_inline(CJsonDecompressor* decompressor, const CJsonCompressedReadOptions* options, CJsonParser* parser) {
+    const size_t block_size = CJSON_MAX(options->block_size, 1);
+    char* block = (char*) cjson_alloc(NULL, block_size);
+    bool read = true;
+    for(;;) {
+        size_t produced = 0;
+        read = cjson_impl_decompressor_read(decompressor, block, block_size, &produced);
+        if(!read || produced == 0 || !cjson_parser_feed(parser, block, produced)) { break; }
+    }
+    cjson_dealloc(NULL, block);
+    return read;
+}
+
+CJsonValue* cjson_impl_read_compressed(CJsonDecompressor* decompressor, const CJsonCompressedReadOptions* options, CJsonAllocator* allocator) {
+    CJsonValue* value = NULL;
+    if(cjson_impl_decompressor_start(decompressor)) {
+        CJsonParser* parser = cjson_parser_acquire();
+        cjson_parser_reset(parser, allocator);
+        cjson_parser_set_max_depth(parser, options->max_depth);
+        const bool decompressed = options->threaded
+            ? cjson_impl_compressed_parse_threaded(decompressor, options, parser)
+            : cjson_impl_compressed_parse_inline(decompressor, options, parser);
+        // Releasing the parser discards the partial tree of a failed read.
+        if(decompressed) {
+            value = cjson_parser_finish(parser);
+        }
+        cjson_parser_release(parser);
+    }
+    cjson_impl_decompressor_end(decompressor);
+    return value;
+}
+
+void cjson_impl_decompressor_init(CJsonDecompressor* this, CJsonCompression compression) {
+    memset(this, 0, sizeof(CJsonDecompressor));
+    this->compression = compression;
+    this->fd = -1;
+}
+
+CJsonCompressedReadOptions cjson_compressed_read_options_default() {
+    const CJsonCompressedReadOptions options = {
+        .compression = cjson_auto_compression,
+        .block_size = CJSON_COMPRESSED_BLOCK_SIZE,
+        .block_count = CJSON_COMPRESSED_BLOCK_COUNT,
+        .threaded = true,
+        .max_depth = 0
+    };
+    return options;
+}
+
+CJsonValue* cjson_read_compressed(const char* data, size_t size, const CJsonCompressedReadOptions* options, CJsonAllocator* allocator) {
+    const CJsonCompressedReadOptions default_options = cjson_compressed_read_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonDecompressor decompressor;
+    cjson_impl_decompressor_init(&decompressor, options->compression);
+    decompressor.input = (const unsigned char*) data;
+    decompressor.input_size = size;
+    decompressor.input_eof = true;
+    return cjson_impl_read_compressed(&decompressor, options, allocator);
+}
+
+CJsonValue* cjson_read_compressed_fd(int fd, const CJsonCompressedReadOptions* options, CJsonAllocator* allocator) {
+    const CJsonCompressedReadOptions default_options = cjson_compressed_read_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonDecompressor decompressor;
+    cjson_impl_decompressor_init(&decompressor, options->compression);
+    decompressor.fd = fd;
+    // Room for the bytes left over from the previous read on top of a new one.
+    decompressor.read_buffer = (unsigned char*) cjson_alloc(NULL, 2 * CJSON_COMPRESSED_READ_SIZE);
+    decompressor.input = decompressor.read_buffer;
+    return cjson_impl_read_compressed(&decompressor, options, allocator);
+}
@@ -0,0 +1,160 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_cursor.h"
+#include "cjson_parser.h"
+#include "cjson_scanner.h"
+#include "cjson_tokenizer.h"
+
+#include <string.h>
+
+
+// End of the value starting at `cursor`, NULL when it is not terminated. Containers are crossed
+// from one structural character to the next, strings being jumped over in a single scan.
+const char* cjson_impl_cursor_skip_value(const char* cursor, const char* end) {
+    if(cursor == end) { return NULL; }
+    if(*cursor == '"') {
+        const char* closing_quote = cjson_scan_string_end(cursor + 1, end);
+        return closing_quote == NULL ? NULL : closing_quote + 1;
+    }
+    if(*cursor != '{' && *cursor != '[') {
+        const char* scalar_end = cjson_tokenizer_scalar_end(cursor, end);
+        return scalar_end == cursor ? NULL : scalar_end;
+    }
+    size_t depth = 0;
+    for(;;) {
+        cursor = cjson_scan_structural(cursor, end);
+        if(cursor == end) { return NULL; }
+        switch(*cursor) {
+            case '"': {
+                cursor = cjson_scan_string_end(cursor + 1, end);
+                if(cursor == NULL) { return NULL; }
+                break;
+            }
+            case '{':
+            case '[': ++depth; break;
+            case '}':
+            case ']': {
+                if(--depth == 0) { return cursor + 1; }
+                break;
+            }
+            default: break;
+        }
+        ++cursor;
+    }
+}
+
+// Position of the next token after `cursor` if it is `c`, NULL otherwise.
+const char* cjson_impl_cursor_expect(const char* cursor, const char* end, char c) {
+    cursor = cjson_tokenizer_skip_blank(cursor, end);
+    return cursor != end && *cursor == c ? cursor : NULL;
+}
+
+void cjson_cursor_init(CJsonCursor* this, const char* data, size_t size) {
+    this->_end = data + size;
+    this->_value = cjson_tokenizer_skip_blank(data, this->_end);
+}
+
+bool cjson_cursor_type(const CJsonCursor* this, CJsonValueType* type) {
+    if(this->_value == this->_end) { return false; }
+    switch(*this->_value) {
+        case '{': *type = cjson_object_value; return true;
+        case '[': *type = cjson_array_value; return true;
+        case '"': *type = cjson_str_value; return true;
+        case 't':
+        case 'f': *type = cjson_bool_value; return true;
+        case 'n': *type = cjson_null_value; return true;
+        case '-': *type = cjson_number_value; return true;
+        default: {
+            *type = cjson_number_value;
+            return *this->_value >= '0' && *this->_value <= '9';
+        }
+    }
+}
+
+bool cjson_cursor_find_field(CJsonCursor* this, const char* key) {
+    const char* const end = this->_end;
+    if(this->_value == end || *this->_value != '{') { return false; }
+    const size_t key_size = strlen(key);
+    const char* cursor = cjson_tokenizer_skip_blank(this->_value + 1, end);
+    if(cursor != end && *cursor == '}') { return false; }
+    for(;;) {
+        if(cursor == end || *cursor != '"') { return false; }
+        const char* closing_quote = cjson_scan_string_end(cursor + 1, end);
+        if(closing_quote == NULL) { return false; }
+        const bool is_match = (size_t)(closing_quote - cursor - 1) == key_size
+            && memcmp(cursor + 1, key, key_size) == 0;
+        const char* colon = cjson_impl_cursor_expect(closing_quote + 1, end, ':');
+        if(colon == NULL) { return false; }
+        const char* value = cjson_tokenizer_skip_blank(colon + 1, end);
+        if(is_match) {
+            this->_value = value;
+            return true;
+        }
+        const char* value_end = cjson_impl_cursor_skip_value(value, end);
+        if(value_end == NULL) { return false; }
+        const char* comma = cjson_impl_cursor_expect(value_end, end, ',');
+        if(comma == NULL) { return false; }
+        cursor = cjson_tokenizer_skip_blank(comma + 1, end);
+    }
+}
+
+bool cjson_cursor_first_element(CJsonCursor* this) {
+    if(this->_value == this->_end || *this->_value != '[') { return false; }
+    const char* element = cjson_tokenizer_skip_blank(this->_value + 1, this->_end);
+    if(element == this->_end || *element == ']') { return false; }
+    this->_value = element;
+    return true;
+}
+
+bool cjson_cursor_next_element(CJsonCursor* this) {
+    const char* value_end = cjson_impl_cursor_skip_value(this->_value, this->_end);
+    if(value_end == NULL) { return false; }
+    const char* comma = cjson_impl_cursor_expect(value_end, this->_end, ',');
+    if(comma == NULL) { return false; }
+    this->_value = cjson_tokenizer_skip_blank(comma + 1, this->_end);
+    return true;
+}
+
+bool cjson_cursor_get_double(const CJsonCursor* this, double* value) {
+    const char* scalar_end = cjson_tokenizer_scalar_end(this->_value, this->_end);
+    const size_t size = scalar_end - this->_value;
+    if(cjson_tokenizer_classify_scalar(this->_value, size) != cjson_number_scalar) { return false; }
+    *value = cjson_tokenizer_number_value(this->_value, size);
+    return true;
+}
+
+bool cjson_cursor_get_bool(const CJsonCursor* this, bool* value) {
+    const char* scalar_end = cjson_tokenizer_scalar_end(this->_value, this->_end);
+    switch(cjson_tokenizer_classify_scalar(this->_value, scalar_end - this->_value)) {
+        case cjson_true_scalar: *value = true; return true;
+        case cjson_false_scalar: *value = false; return true;
+        default: return false;
+    }
+}
+
+bool cjson_cursor_is_null(const CJsonCursor* this) {
+    const char* scalar_end = cjson_tokenizer_scalar_end(this->_value, this->_end);
+    return cjson_tokenizer_classify_scalar(this->_value, scalar_end - this->_value) == cjson_null_scalar;
+}
+
+bool cjson_cursor_get_string(const CJsonCursor* this, const char** data, size_t* size) {
+    if(this->_value == this->_end || *this->_value != '"') { return false; }
+    const char* closing_quote = cjson_scan_string_end(this->_value + 1, this->_end);
+    if(closing_quote == NULL) { return false; }
+    *data = this->_value + 1;
+    *size = closing_quote - this->_value - 1;
+    return true;
+}
+
+CJsonValue* cjson_cursor_read_value(const CJsonCursor* this, CJsonAllocator* allocator) {
+    const char* value_end = cjson_impl_cursor_skip_value(this->_value, this->_end);
+    if(value_end == NULL) { return NULL; }
+    CJsonParser* parser = cjson_parser_acquire();
+    cjson_parser_reset(parser, allocator);
+    cjson_parser_feed(parser, this->_value, value_end - this->_value);
+    CJsonValue* value = cjson_parser_finish(parser);
+    cjson_parser_release(parser);
+    return value;
+}
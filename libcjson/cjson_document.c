@@ -0,0 +1,299 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_allocator.h"
+#include "cjson_array.h"
+#include "cjson_cursor.h"
+#include "cjson_document.h"
+#include "cjson_parser.h"
+#include "cjson_reader.h"
+#include "cjson_tokenizer.h"
+#include "cjson_utils.h"
+#include "cjson_value.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The arenas of documents read from JSON text reserve CJSON_DOCUMENT_ARENA_RESERVE_FACTOR times its
+// size, plus CJSON_DOCUMENT_ARENA_RESERVE_BASE bytes, of address space, committed as it gets used.
+#ifndef CJSON_DOCUMENT_ARENA_RESERVE_FACTOR
+#define CJSON_DOCUMENT_ARENA_RESERVE_FACTOR 64
+#endif
+
+#ifndef CJSON_DOCUMENT_ARENA_RESERVE_BASE
+#define CJSON_DOCUMENT_ARENA_RESERVE_BASE ((size_t) 64 << 20)
+#endif
+
+#ifndef CJSON_DOCUMENT_MIN_SLICE_SIZE
+#define CJSON_DOCUMENT_MIN_SLICE_SIZE ((size_t) 1 << 20)
+#endif
+
+
+// Elements of the root array parsed by one thread.
+typedef struct CJsonDocumentSlice {
+    // Elements and the commas between them, without the brackets of the root.
+    const char* data;
+    size_t size;
+    // Position of the first element in the root, and number of elements.
+    size_t first;
+    size_t count;
+    CJsonArray* root;
+    CJsonAllocator* arena;
+    size_t max_depth;
+    bool failed;
+    pthread_t thread;
+} CJsonDocumentSlice;
+
+
+size_t cjson_impl_document_arena_reserve(size_t size) {
+    return CJSON_DOCUMENT_ARENA_RESERVE_FACTOR * size + CJSON_DOCUMENT_ARENA_RESERVE_BASE;
+}
+
+// Document owning `arena`, a new linear allocator, which is freed when the document cannot be made.
+CJsonDocument* cjson_impl_document_new_owning(CJsonAllocator* arena) {
+    if(arena == NULL) { return NULL; }
+    CJsonDocument* document = cjson_document_new_with_arena(arena);
+    if(document == NULL) {
+        cjson_linear_allocator_free(arena);
+    }
+    return document;
+}
+
+CJsonDocument* cjson_document_new(size_t arena_size) {
+    return cjson_impl_document_new_owning(cjson_linear_allocator_new(arena_size));
+}
+
+CJsonDocument* cjson_document_new_with_arena(CJsonAllocator* arena) {
+    // Linear allocators are recognised by their entry points, like in cjson_alloc.
+    if(arena == NULL || arena->alloc != cjson_linear_allocator_alloc) { return NULL; }
+    CJsonDocument* document = (CJsonDocument*) malloc(sizeof(CJsonDocument));
+    if(document == NULL) { return NULL; }
+    document->_allocator = arena;
+    document->_root = NULL;
+    document->_arenas = NULL;
+    document->_arena_count = 0;
+    document->_input = NULL;
+    return document;
+}
+
+CJsonDocument* cjson_document_read(char* data, size_t arena_size) {
+    CJsonDocument* document = cjson_document_new(arena_size);
+    if(document == NULL) { return NULL; }
+    document->_root = cjson_read(data, document->_allocator);
+    if(document->_root == NULL) {
+        cjson_document_free(document);
+        return NULL;
+    }
+    return document;
+}
+
+CJsonDocument* cjson_document_read_presized(char* data) {
+    const size_t arena_size = cjson_read_arena_size(data);
+    if(arena_size == 0) { return NULL; }
+    CJsonDocument* document = cjson_document_new(arena_size);
+    if(document == NULL) { return NULL; }
+    document->_root = cjson_read_presized(data, document->_allocator);
+    if(document->_root == NULL) {
+        cjson_document_free(document);
+        return NULL;
+    }
+    return document;
+}
+
+// The slice is read as an array of its own, whose elements are then moved into the root.
+void* cjson_impl_document_read_slice(void* argument) {
+    CJsonDocumentSlice* this = (CJsonDocumentSlice*) argument;
+    CJsonParser* parser = cjson_parser_new(NULL);
+    cjson_parser_reset(parser, this->arena);
+    cjson_parser_set_max_depth(parser, this->max_depth);
+    cjson_parser_feed(parser, "[", 1);
+    cjson_parser_feed(parser, this->data, this->size);
+    cjson_parser_feed(parser, "]", 1);
+    CJsonValue* elements = cjson_parser_finish(parser);
+    cjson_parser_free(parser);
+    if(elements == NULL || cjson_array_size(cjson_value_get_array(elements)) != this->count) {
+        this->failed = true;
+        return NULL;
+    }
+    memcpy(this->root->_data + this->first, cjson_value_get_array(elements)->_data, this->count * sizeof(CJsonValue*));
+    return NULL;
+}
+
+// Splits the elements of the root array into at most `max_slices` slices of about the same size.
+// Elements are stepped over without being validated, which is left to the threads reading them.
+bool cjson_impl_document_split(const char* data, size_t size, CJsonDocumentSlice* slices, size_t max_slices,
+                               size_t* slice_count, size_t* element_count) {
+    const char* const end = data + size;
+    const char* cursor = cjson_tokenizer_skip_blank(data, end) + 1;
+    const size_t target_size = size / max_slices;
+    *slice_count = 0;
+    *element_count = 0;
+    cursor = cjson_tokenizer_skip_blank(cursor, end);
+    if(cursor != end && *cursor == ']') {
+        return cjson_tokenizer_skip_blank(cursor + 1, end) == end;
+    }
+    const char* slice_begin = cursor;
+    size_t slice_first = 0;
+    for(;;) {
+        const char* value_end = cjson_impl_cursor_skip_value(cursor, end);
+        if(value_end == NULL) { return false; }
+        ++*element_count;
+        const char* separator = cjson_tokenizer_skip_blank(value_end, end);
+        if(separator == end || (*separator != ',' && *separator != ']')) { return false; }
+        const bool is_last = *separator == ']';
+        if(is_last || (separator - slice_begin >= (ptrdiff_t) target_size && *slice_count + 1 < max_slices)) {
+            CJsonDocumentSlice* slice = &slices[(*slice_count)++];
+            slice->data = slice_begin;
+            slice->size = separator - slice_begin;
+            slice->first = slice_first;
+            slice->count = *element_count - slice_first;
+            slice_begin = separator + 1;
+            slice_first = *element_count;
+        }
+        if(is_last) {
+            return cjson_tokenizer_skip_blank(separator + 1, end) == end;
+        }
+        cursor = cjson_tokenizer_skip_blank(separator + 1, end);
+    }
+}
+
+bool cjson_impl_document_read_slices(CJsonDocument* this, CJsonDocumentSlice* slices, size_t slice_count,
+                                     size_t element_count, size_t max_depth) {
+    CJsonArray* root = cjson_array_new_with_capacity(element_count, this->_allocator);
+    this->_root = cjson_value_new_as_array(root, this->_allocator);
+    this->_arenas = (CJsonAllocator**) cjson_alloc(NULL, slice_count * sizeof(CJsonAllocator*));
+    if(this->_arenas == NULL) { return false; }
+    for(size_t i = 0; i < slice_count; ++i) {
+        const size_t reserve_size = cjson_impl_document_arena_reserve(slices[i].size);
+        CJsonAllocator* arena = cjson_mapped_linear_allocator_new(reserve_size, 0, cjson_mapped_arena_no_flags);
+        if(arena == NULL) { return false; }
+        this->_arenas[this->_arena_count++] = arena;
+        slices[i].root = root;
+        slices[i].arena = arena;
+        slices[i].max_depth = max_depth;
+        slices[i].failed = false;
+    }
+    // The calling thread reads the first slice itself.
+    size_t started = 1;
+    for(; started < slice_count; ++started) {
+        if(pthread_create(&slices[started].thread, NULL, cjson_impl_document_read_slice, &slices[started]) != 0) { break; }
+    }
+    cjson_impl_document_read_slice(&slices[0]);
+    for(size_t i = 1; i < started; ++i) {
+        pthread_join(slices[i].thread, NULL);
+    }
+    for(size_t i = started; i < slice_count; ++i) {
+        cjson_impl_document_read_slice(&slices[i]);
+    }
+    for(size_t i = 0; i < slice_count; ++i) {
+        if(slices[i].failed) { return false; }
+    }
+    root->_size = element_count;
+    return true;
+}
+
+CJsonDocument* cjson_document_read_file(const char* path, const CJsonReadOptions* options) {
+    const CJsonReadOptions default_options = cjson_read_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonFileInput* input = (CJsonFileInput*) cjson_alloc(NULL, sizeof(CJsonFileInput));
+    if(input == NULL) { return NULL; }
+    if(!cjson_impl_file_input_open(input, path, options->in_situ)) {
+        cjson_dealloc(NULL, input);
+        return NULL;
+    }
+    const size_t reserve_size = cjson_impl_document_arena_reserve(input->size);
+    CJsonAllocator* arena = cjson_mapped_linear_allocator_new(reserve_size, 0, cjson_mapped_arena_huge_pages);
+    CJsonDocument* document = cjson_impl_document_new_owning(arena);
+    if(document == NULL) {
+        cjson_impl_file_input_close(input);
+        cjson_dealloc(NULL, input);
+        return NULL;
+    }
+    document->_input = input;
+    document->_root = cjson_read_bytes(document->_input->data, document->_input->size, options, document->_allocator);
+    if(document->_root == NULL) {
+        cjson_document_free(document);
+        return NULL;
+    }
+    return document;
+}
+
+CJsonParallelReadOptions cjson_parallel_read_options_default() {
+    const CJsonParallelReadOptions options = {
+        .threads = 0,
+        .min_slice_size = CJSON_DOCUMENT_MIN_SLICE_SIZE,
+        .max_depth = 0
+    };
+    return options;
+}
+
+CJsonDocument* cjson_document_read_parallel(const char* data, size_t size, const CJsonParallelReadOptions* options) {
+    const CJsonParallelReadOptions default_options = cjson_parallel_read_options_default();
+    if(options == NULL) { options = &default_options; }
+    const size_t reserve_size = cjson_impl_document_arena_reserve(size);
+    CJsonAllocator* arena = cjson_mapped_linear_allocator_new(reserve_size, 0, cjson_mapped_arena_no_flags);
+    CJsonDocument* document = cjson_impl_document_new_owning(arena);
+    if(document == NULL) { return NULL; }
+
+    const size_t max_slices = CJSON_MIN(cjson_thread_count(options->threads), size / CJSON_MAX(options->min_slice_size, 1));
+    const char* root = cjson_tokenizer_skip_blank(data, data + size);
+    if(max_slices <= 1 || root == data + size || *root != '[') {
+        CJsonParser* parser = cjson_parser_new(NULL);
+        cjson_parser_reset(parser, document->_allocator);
+        cjson_parser_set_max_depth(parser, options->max_depth);
+        document->_root = cjson_parser_read(parser, data, size);
+        cjson_parser_free(parser);
+        if(document->_root == NULL) {
+            cjson_document_free(document);
+            return NULL;
+        }
+        return document;
+    }
+
+    CJsonDocumentSlice* slices = (CJsonDocumentSlice*) cjson_alloc(NULL, max_slices * sizeof(CJsonDocumentSlice));
+    if(slices == NULL) {
+        cjson_document_free(document);
+        return NULL;
+    }
+    size_t slice_count = 0;
+    size_t element_count = 0;
+    bool read = cjson_impl_document_split(data, size, slices, max_slices, &slice_count, &element_count);
+    if(read && slice_count == 0) {
+        document->_root = CJSON_EMPTY_ARRAY_V_A(document->_allocator);
+    } else if(read) {
+        read = cjson_impl_document_read_slices(document, slices, slice_count, element_count, options->max_depth);
+    }
+    cjson_dealloc(NULL, slices);
+    if(!read) {
+        cjson_document_free(document);
+        return NULL;
+    }
+    return document;
+}
+
+void cjson_document_free(CJsonDocument* this) {
+    cjson_linear_allocator_free(this->_allocator);
+    for(size_t i = 0; i < this->_arena_count; ++i) {
+        cjson_linear_allocator_free(this->_arenas[i]);
+    }
+    cjson_dealloc(NULL, this->_arenas);
+    if(this->_input != NULL) {
+        cjson_impl_file_input_close(this->_input);
+        cjson_dealloc(NULL, this->_input);
+    }
+    free(this);
+}
+
+CJsonValue* cjson_document_root(CJsonDocument* this) {
+    return this->_root;
+}
+
+void cjson_document_set_root(CJsonDocument* this, CJsonValue* root) {
+    this->_root = root;
+}
+
+CJsonAllocator* cjson_document_allocator(CJsonDocument* this) {
+    return this->_allocator;
+}
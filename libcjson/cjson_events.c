@@ -0,0 +1,104 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_assert.h"
+#include "cjson_events.h"
+#include "cjson_scanner.h"
+#include "cjson_tokenizer.h"
+
+CJSON_STATIC_ASSERT(CJSON_EVENTS_MAX_DEPTH <= CJSON_SYNTAX_MAX_DEPTH);
+
+
+bool cjson_events_emit(bool (*callback)(void*), void* context) {
+    return callback == NULL || callback(context);
+}
+
+bool cjson_events_scalar(const CJsonHandler* handler, void* context, const char* data, size_t size) {
+    switch(cjson_tokenizer_classify_scalar(data, size)) {
+        case cjson_null_scalar: return cjson_events_emit(handler->null, context);
+        case cjson_true_scalar: return handler->boolean == NULL || handler->boolean(context, true);
+        case cjson_false_scalar: return handler->boolean == NULL || handler->boolean(context, false);
+        case cjson_number_scalar: return handler->number == NULL || handler->number(context, cjson_tokenizer_number_value(data, size));
+        case cjson_invalid_scalar: return false;
+    }
+    return false;
+}
+
+bool cjson_read_events(const char* data, size_t size, const CJsonHandler* handler, void* context) {
+    const char* cursor = data;
+    const char* const end = data + size;
+    CJsonSyntaxStack stack;
+    cjson_syntax_stack_init(&stack);
+    CJsonSyntaxState state = cjson_syntax_value_state;
+    for(;;) {
+        cursor = cjson_tokenizer_skip_blank(cursor, end);
+        if(cursor == end) { break; }
+        const char c = *cursor;
+        switch(c) {
+            case '{':
+            case '[': {
+                const bool is_object = c == '{';
+                if(!cjson_syntax_expects_value(state) || !cjson_syntax_stack_push(&stack, is_object, CJSON_EVENTS_MAX_DEPTH)) { return false; }
+                if(!cjson_events_emit(is_object ? handler->start_object : handler->start_array, context)) { return false; }
+                state = cjson_syntax_after_open(is_object);
+                ++cursor;
+                break;
+            }
+            case '}':
+            case ']': {
+                const bool is_object = c == '}';
+                if(stack.depth == 0 || cjson_syntax_stack_top_is_object(&stack) != is_object
+                   || !cjson_syntax_can_close(state, is_object)) {
+                    return false;
+                }
+                cjson_syntax_stack_pop(&stack);
+                if(!cjson_events_emit(is_object ? handler->end_object : handler->end_array, context)) { return false; }
+                state = cjson_syntax_after_value(stack.depth);
+                ++cursor;
+                break;
+            }
+            case ',': {
+                if(state != cjson_syntax_separator_state) { return false; }
+                state = cjson_syntax_after_comma(cjson_syntax_stack_top_is_object(&stack));
+                ++cursor;
+                break;
+            }
+            case ':': {
+                if(state != cjson_syntax_colon_state) { return false; }
+                state = cjson_syntax_value_state;
+                ++cursor;
+                break;
+            }
+            case '"': {
+                const char* closing_quote = cjson_scan_string_end(cursor + 1, end);
+                if(closing_quote == NULL) { return false; }
+                const size_t length = closing_quote - cursor - 1;
+                if(cjson_syntax_expects_key(state)) {
+                    if(handler->key != NULL && !handler->key(context, cursor + 1, length)) { return false; }
+                    state = cjson_syntax_colon_state;
+                }
+                else if(cjson_syntax_expects_value(state)) {
+                    if(handler->string != NULL && !handler->string(context, cursor + 1, length)) { return false; }
+                    state = cjson_syntax_after_value(stack.depth);
+                }
+                else {
+                    return false;
+                }
+                cursor = closing_quote + 1;
+                break;
+            }
+            default: {
+                const char* scalar_end = cjson_tokenizer_scalar_end(cursor, end);
+                if(!cjson_syntax_expects_value(state)
+                   || !cjson_events_scalar(handler, context, cursor, scalar_end - cursor)) {
+                    return false;
+                }
+                state = cjson_syntax_after_value(stack.depth);
+                cursor = scalar_end;
+                break;
+            }
+        }
+    }
+    return state == cjson_syntax_done_state;
+}
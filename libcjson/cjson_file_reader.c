@@ -0,0 +1,476 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#define _GNU_SOURCE
+
+#include "cjson_file_reader.h"
+#include "cjson_allocator.h"
+#include "cjson_utils.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define CJSON_FILE_READER_IO_URING
+#endif
+
+#ifndef CJSON_FILE_READER_QUEUE_DEPTH
+#define CJSON_FILE_READER_QUEUE_DEPTH 64
+#endif
+
+// First read of every file, grown for larger files.
+#ifndef CJSON_FILE_READER_BUFFER_SIZE
+#define CJSON_FILE_READER_BUFFER_SIZE ((size_t) 1 << 16)
+#endif
+
+
+typedef struct CJsonFileBatch {
+    const char* const* paths;
+    size_t count;
+    CJsonReadOptions read_options;
+    CJsonFileHandler handler;
+    void* context;
+    CJsonAllocator* allocator;
+    // Files before this one were handed over, or are being read.
+    size_t next_file;
+    bool stopped;
+} CJsonFileBatch;
+
+// Parses the content of file `index` and hands it over.
+void cjson_impl_file_batch_hand_over(CJsonFileBatch* this, size_t index, char* data, size_t size, int error) {
+    if(this->stopped) { return; }
+    CJsonFileRecord record;
+    record.index = index;
+    record.path = this->paths[index];
+    record.error = error;
+    record.value = error == 0 ? cjson_read_bytes(data, size, &this->read_options, this->allocator) : NULL;
+    if(!this->handler(this->context, &record)) {
+        this->stopped = true;
+    }
+}
+
+#ifdef CJSON_FILE_READER_IO_URING
+
+typedef enum CJsonFileOperation {
+    cjson_file_open_operation = 0,
+    cjson_file_read_operation,
+    cjson_file_close_operation
+} CJsonFileOperation;
+
+// Memory shared with the kernel: a submission ring of indices into an array of entries, and a
+// completion ring. Each side only moves the head or tail it owns.
+typedef struct CJsonIoRing {
+    int fd;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned to_submit;
+} CJsonIoRing;
+
+// A file being read through the ring.
+typedef struct CJsonFileSlot {
+    size_t index;
+    int fd;
+    char* buffer;
+    size_t capacity;
+    size_t size;
+    // The file is yet to be handed over.
+    bool pending;
+} CJsonFileSlot;
+
+bool cjson_impl_io_ring_supports(int fd) {
+    const size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = (struct io_uring_probe*) cjson_alloc(NULL, probe_size);
+    memset(probe, 0, probe_size);
+    bool supported = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    const int operations[] = {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE};
+    for(size_t i = 0; supported && i < sizeof(operations) / sizeof(operations[0]); ++i) {
+        supported = operations[i] <= probe->last_op && (probe->ops[operations[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+    cjson_dealloc(NULL, probe);
+    return supported;
+}
+
+void cjson_impl_io_ring_close(CJsonIoRing* this) {
+    if(this->sqes != NULL && this->sqes != MAP_FAILED) {
+        munmap(this->sqes, this->sqes_size);
+    }
+    if(this->cq_ring != NULL && this->cq_ring != MAP_FAILED && this->cq_ring != this->sq_ring) {
+        munmap(this->cq_ring, this->cq_ring_size);
+    }
+    if(this->sq_ring != NULL && this->sq_ring != MAP_FAILED) {
+        munmap(this->sq_ring, this->sq_ring_size);
+    }
+    close(this->fd);
+}
+
+// False when the kernel has no io_uring, forbids it, or lacks the operations needed.
+bool cjson_impl_io_ring_open(CJsonIoRing* this, unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(this, 0, sizeof(CJsonIoRing));
+    this->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if(this->fd < 0) { return false; }
+    if(!cjson_impl_io_ring_supports(this->fd)) {
+        close(this->fd);
+        return false;
+    }
+    this->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    this->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mapping = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(single_mapping) {
+        this->sq_ring_size = this->cq_ring_size = CJSON_MAX(this->sq_ring_size, this->cq_ring_size);
+    }
+    this->sq_ring = mmap(NULL, this->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQ_RING);
+    this->cq_ring = single_mapping
+        ? this->sq_ring
+        : mmap(NULL, this->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_CQ_RING);
+    this->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    this->sqes = (struct io_uring_sqe*) mmap(NULL, this->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, IORING_OFF_SQES);
+    if(this->sq_ring == MAP_FAILED || this->cq_ring == MAP_FAILED || this->sqes == MAP_FAILED) {
+        cjson_impl_io_ring_close(this);
+        return false;
+    }
+    char* sq_ring = (char*) this->sq_ring;
+    char* cq_ring = (char*) this->cq_ring;
+    this->sq_head = (unsigned*) (sq_ring + params.sq_off.head);
+    this->sq_tail = (unsigned*) (sq_ring + params.sq_off.tail);
+    this->sq_mask = *(unsigned*) (sq_ring + params.sq_off.ring_mask);
+    this->sq_array = (unsigned*) (sq_ring + params.sq_off.array);
+    this->cq_head = (unsigned*) (cq_ring + params.cq_off.head);
+    this->cq_tail = (unsigned*) (cq_ring + params.cq_off.tail);
+    this->cq_mask = *(unsigned*) (cq_ring + params.cq_off.ring_mask);
+    this->cqes = (struct io_uring_cqe*) (cq_ring + params.cq_off.cqes);
+    return true;
+}
+
+// The ring holds an entry for every operation in flight, so it is never full.
+struct io_uring_sqe* cjson_impl_io_ring_push(CJsonIoRing* this, uint8_t opcode, size_t slot, CJsonFileOperation operation) {
+    const unsigned tail = *this->sq_tail;
+    const unsigned index = tail & this->sq_mask;
+    struct io_uring_sqe* sqe = &this->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = opcode;
+    sqe->user_data = ((uint64_t) slot << 2) | operation;
+    this->sq_array[index] = index;
+    __atomic_store_n(this->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++this->to_submit;
+    return sqe;
+}
+
+// Submits the pending entries and waits for a completion. The kernel running short of resources
+// is no failure: completions are reaped before trying again.
+bool cjson_impl_io_ring_submit_and_wait(CJsonIoRing* this) {
+    for(;;) {
+        const long submitted = syscall(__NR_io_uring_enter, this->fd, this->to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if(submitted >= 0) {
+            this->to_submit -= (unsigned) submitted;
+            return true;
+        }
+        if(errno == EINTR) { continue; }
+        return errno == EAGAIN || errno == EBUSY;
+    }
+}
+
+void cjson_impl_file_slot_open(CJsonIoRing* ring, CJsonFileSlot* slots, size_t slot, const char* path) {
+    struct io_uring_sqe* sqe = cjson_impl_io_ring_push(ring, IORING_OP_OPENAT, slot, cjson_file_open_operation);
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) (uintptr_t) path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    slots[slot].size = 0;
+    slots[slot].pending = true;
+}
+
+// Returns false, submitting nothing, when the buffer of the slot cannot grow.
+bool cjson_impl_file_slot_read(CJsonIoRing* ring, CJsonFileSlot* slots, size_t slot) {
+    CJsonFileSlot* this = &slots[slot];
+    if(this->size == this->capacity) {
+        const size_t capacity = CJSON_MAX(this->capacity * 2, CJSON_FILE_READER_BUFFER_SIZE);
+        char* buffer = (char*) cjson_realloc(NULL, this->buffer, capacity);
+        if(buffer == NULL) { return false; }
+        this->buffer = buffer;
+        this->capacity = capacity;
+    }
+    struct io_uring_sqe* sqe = cjson_impl_io_ring_push(ring, IORING_OP_READ, slot, cjson_file_read_operation);
+    sqe->fd = this->fd;
+    sqe->addr = (uint64_t) (uintptr_t) (this->buffer + this->size);
+    sqe->len = (uint32_t) CJSON_MIN(this->capacity - this->size, (size_t) 1 << 30);
+    sqe->off = this->size;
+    return true;
+}
+
+void cjson_impl_file_slot_close(CJsonIoRing* ring, CJsonFileSlot* slots, size_t slot) {
+    struct io_uring_sqe* sqe = cjson_impl_io_ring_push(ring, IORING_OP_CLOSE, slot, cjson_file_close_operation);
+    sqe->fd = slots[slot].fd;
+}
+
+// Every slot goes through open, reads until the end of the file, then close. Files are parsed
+// once read, ahead of their close; the slot then moves on to the next file. Returns false
+// when io_uring cannot be used, leaving the files from `next_file` on to be read otherwise.
+bool cjson_impl_file_batch_read_io_uring(CJsonFileBatch* this, size_t queue_depth) {
+    CJsonIoRing ring;
+    const size_t slot_count = CJSON_MIN(queue_depth, this->count);
+    // Slots have a single operation in flight at a time.
+    if(!cjson_impl_io_ring_open(&ring, (unsigned) slot_count)) { return false; }
+    CJsonFileSlot* slots = (CJsonFileSlot*) cjson_alloc(NULL, slot_count * sizeof(CJsonFileSlot));
+    size_t in_flight = 0;
+    for(size_t s = 0; s < slot_count; ++s) {
+        slots[s].buffer = NULL;
+        slots[s].capacity = 0;
+        slots[s].index = this->next_file++;
+        cjson_impl_file_slot_open(&ring, slots, s, this->paths[slots[s].index]);
+        ++in_flight;
+    }
+    while(in_flight > 0) {
+        if(!cjson_impl_io_ring_submit_and_wait(&ring)) {
+            // The operations in flight may still write to the buffers after the ring is closed:
+            // those are leaked, and the files being read are handed over as failed.
+            const int error = errno;
+            cjson_impl_io_ring_close(&ring);
+            for(size_t s = 0; s < slot_count; ++s) {
+                if(slots[s].pending) {
+                    cjson_impl_file_batch_hand_over(this, slots[s].index, NULL, 0, error);
+                }
+            }
+            cjson_dealloc(NULL, slots);
+            return false;
+        }
+        unsigned head = *ring.cq_head;
+        const unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for(; head != tail; ++head) {
+            const struct io_uring_cqe* cqe = &ring.cqes[head & ring.cq_mask];
+            const size_t s = (size_t) (cqe->user_data >> 2);
+            const CJsonFileOperation operation = (CJsonFileOperation) (cqe->user_data & 3);
+            const int result = cqe->res;
+            CJsonFileSlot* slot = &slots[s];
+            --in_flight;
+            bool slot_done = false;
+            switch(operation) {
+                case cjson_file_open_operation: {
+                    if(result < 0) {
+                        slot->pending = false;
+                        cjson_impl_file_batch_hand_over(this, slot->index, NULL, 0, -result);
+                        slot_done = true;
+                        break;
+                    }
+                    slot->fd = result;
+                    ++in_flight;
+                    if(!this->stopped && cjson_impl_file_slot_read(&ring, slots, s)) { break; }
+                    cjson_impl_file_slot_close(&ring, slots, s);
+                    if(!this->stopped) {
+                        slot->pending = false;
+                        cjson_impl_file_batch_hand_over(this, slot->index, NULL, 0, ENOMEM);
+                    }
+                    break;
+                }
+                case cjson_file_read_operation: {
+                    int error = result < 0 ? -result : 0;
+                    if(result > 0 && !this->stopped) {
+                        slot->size += result;
+                        if(cjson_impl_file_slot_read(&ring, slots, s)) {
+                            ++in_flight;
+                            break;
+                        }
+                        error = ENOMEM;
+                    }
+                    cjson_impl_file_slot_close(&ring, slots, s);
+                    ++in_flight;
+                    // The buffer is left alone until the next open, after the close is submitted.
+                    slot->pending = false;
+                    cjson_impl_file_batch_hand_over(this, slot->index, slot->buffer, slot->size, error);
+                    break;
+                }
+                case cjson_file_close_operation: slot_done = true; break;
+            }
+            if(slot_done && !this->stopped && this->next_file < this->count) {
+                slot->index = this->next_file++;
+                cjson_impl_file_slot_open(&ring, slots, s, this->paths[slot->index]);
+                ++in_flight;
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+    cjson_impl_io_ring_close(&ring);
+    for(size_t s = 0; s < slot_count; ++s) {
+        cjson_dealloc(NULL, slots[s].buffer);
+    }
+    cjson_dealloc(NULL, slots);
+    return true;
+}
+
+#endif
+
+// Fallback without io_uring: threads read whole files into buffers which the calling thread
+// parses, through a queue of `capacity` files.
+typedef struct CJsonFileQueueEntry {
+    size_t index;
+    CJsonFileInput input;
+    int error;
+} CJsonFileQueueEntry;
+
+typedef struct CJsonFileQueue {
+    CJsonFileBatch* batch;
+    atomic_size_t next_file;
+    CJsonFileQueueEntry* entries;
+    size_t capacity;
+    size_t head;
+    size_t size;
+    bool stopped;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} CJsonFileQueue;
+
+void cjson_impl_file_queue_entry_read(CJsonFileQueueEntry* this, const char* path, size_t index) {
+    this->index = index;
+    this->error = 0;
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0 || !cjson_impl_file_input_read(&this->input, fd)) {
+        this->error = errno;
+        this->input.data = NULL;
+        this->input.size = 0;
+    }
+    if(fd >= 0) {
+        close(fd);
+    }
+}
+
+void* cjson_impl_file_queue_worker_main(void* argument) {
+    CJsonFileQueue* this = (CJsonFileQueue*) argument;
+    for(;;) {
+        const size_t index = atomic_fetch_add(&this->next_file, 1);
+        if(index >= this->batch->count) { return NULL; }
+        CJsonFileQueueEntry entry;
+        cjson_impl_file_queue_entry_read(&entry, this->batch->paths[index], index);
+        pthread_mutex_lock(&this->mutex);
+        while(this->size == this->capacity && !this->stopped) {
+            pthread_cond_wait(&this->not_full, &this->mutex);
+        }
+        if(this->stopped) {
+            pthread_mutex_unlock(&this->mutex);
+            cjson_dealloc(NULL, entry.input.data);
+            return NULL;
+        }
+        this->entries[(this->head + this->size++) % this->capacity] = entry;
+        pthread_cond_signal(&this->not_empty);
+        pthread_mutex_unlock(&this->mutex);
+    }
+}
+
+void cjson_impl_file_batch_read_threads(CJsonFileBatch* this, size_t queue_depth, size_t threads) {
+    const size_t file_count = this->count - this->next_file;
+    if(file_count == 0) { return; }
+    CJsonFileQueue queue;
+    queue.batch = this;
+    atomic_init(&queue.next_file, this->next_file);
+    queue.capacity = CJSON_MAX(queue_depth, 1);
+    queue.entries = (CJsonFileQueueEntry*) cjson_alloc(NULL, queue.capacity * sizeof(CJsonFileQueueEntry));
+    queue.head = 0;
+    queue.size = 0;
+    queue.stopped = false;
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+
+    const size_t worker_count = queue.entries == NULL ? 0 : CJSON_MIN(cjson_thread_count(threads), file_count);
+    pthread_t* workers = worker_count == 0 ? NULL : (pthread_t*) cjson_alloc(NULL, worker_count * sizeof(pthread_t));
+    size_t started = 0;
+    while(workers != NULL && started < worker_count
+          && pthread_create(&workers[started], NULL, cjson_impl_file_queue_worker_main, &queue) == 0) {
+        ++started;
+    }
+    // Without any thread, the calling thread reads the files itself.
+    for(size_t index = this->next_file; started == 0 && index < this->count && !this->stopped; ++index) {
+        CJsonFileQueueEntry entry;
+        cjson_impl_file_queue_entry_read(&entry, this->paths[index], index);
+        cjson_impl_file_batch_hand_over(this, entry.index, entry.input.data, entry.input.size, entry.error);
+        cjson_dealloc(NULL, entry.input.data);
+    }
+    for(size_t handed_over = 0; started > 0 && handed_over < file_count && !this->stopped; ++handed_over) {
+        pthread_mutex_lock(&queue.mutex);
+        while(queue.size == 0) {
+            pthread_cond_wait(&queue.not_empty, &queue.mutex);
+        }
+        CJsonFileQueueEntry entry = queue.entries[queue.head];
+        queue.head = (queue.head + 1) % queue.capacity;
+        --queue.size;
+        pthread_cond_signal(&queue.not_full);
+        pthread_mutex_unlock(&queue.mutex);
+        cjson_impl_file_batch_hand_over(this, entry.index, entry.input.data, entry.input.size, entry.error);
+        cjson_dealloc(NULL, entry.input.data);
+    }
+
+    pthread_mutex_lock(&queue.mutex);
+    queue.stopped = true;
+    pthread_cond_broadcast(&queue.not_full);
+    pthread_mutex_unlock(&queue.mutex);
+    for(size_t w = 0; w < started; ++w) {
+        pthread_join(workers[w], NULL);
+    }
+    for(size_t i = 0; i < queue.size; ++i) {
+        cjson_dealloc(NULL, queue.entries[(queue.head + i) % queue.capacity].input.data);
+    }
+    cjson_dealloc(NULL, workers);
+    cjson_dealloc(NULL, queue.entries);
+    pthread_cond_destroy(&queue.not_full);
+    pthread_cond_destroy(&queue.not_empty);
+    pthread_mutex_destroy(&queue.mutex);
+}
+
+CJsonReadFilesOptions cjson_read_files_options_default() {
+    const CJsonReadFilesOptions options = {
+        .queue_depth = CJSON_FILE_READER_QUEUE_DEPTH,
+        .io_uring = true,
+        .threads = 0,
+        .read_options = cjson_read_options_default()
+    };
+    return options;
+}
+
+bool cjson_read_files(const char* const* paths, size_t count, const CJsonReadFilesOptions* options,
+                      CJsonFileHandler handler, void* context, CJsonAllocator* allocator) {
+    const CJsonReadFilesOptions default_options = cjson_read_files_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonFileBatch batch;
+    batch.paths = paths;
+    batch.count = count;
+    batch.read_options = options->read_options;
+    batch.read_options.lazy = false;
+    batch.read_options.in_situ = false;
+    batch.handler = handler;
+    batch.context = context;
+    batch.allocator = allocator;
+    batch.next_file = 0;
+    batch.stopped = false;
+    const size_t queue_depth = CJSON_MAX(options->queue_depth, 1);
+#ifdef CJSON_FILE_READER_IO_URING
+    if(options->io_uring && count > 0 && cjson_impl_file_batch_read_io_uring(&batch, queue_depth)) {
+        return !batch.stopped;
+    }
+    // Only files the ring did not get to are left.
+#endif
+    if(!batch.stopped) {
+        cjson_impl_file_batch_read_threads(&batch, queue_depth, options->threads);
+    }
+    return !batch.stopped;
+}
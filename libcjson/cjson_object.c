@@ -11,6 +11,7 @@
 #include "cjson_str.h"
 #include "cjson_value.h"
 #include "cjson_allocator.h"
+#include "cjson_writer.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -37,8 +38,8 @@ typedef struct CJsonObjectNode {
 } CJsonObjectNode;
 
 CJsonObjectNode* cjson_object_node_new(const char* key, CJsonValue* val, CJsonObjectNode** block_ref, CJsonAllocator* allocator) {
-    CJsonObjectNode* node = (CJsonObjectNode*) cjson_alloc(allocator, sizeof(CJsonObjectNode));
-    node->key = (char*) cjson_alloc(allocator, (strlen(key) + 1) * sizeof(char));
+    CJsonObjectNode* node = (CJsonObjectNode*) cjson_alloc_kind(allocator, sizeof(CJsonObjectNode), cjson_object_node_allocation);
+    node->key = (char*) cjson_alloc_kind(allocator, (strlen(key) + 1) * sizeof(char), cjson_key_allocation);
     strcpy(node->key, key);
     node->val = val;
     node->next = NULL;
@@ -110,10 +111,14 @@ size_t cjson_impl_object_get_block(CJsonObject* this, const char* key) {
 }
 
 CJsonObject* cjson_object_new(CJsonAllocator* allocator) {
+    return cjson_object_new_with_capacity(k_default_hash_table_size, allocator);
+}
+
+CJsonObject* cjson_object_new_with_capacity(size_t capacity, CJsonAllocator* allocator) {
     allocator = cjson_allocator_or_default(allocator);
-    CJsonObject* obj = (CJsonObject*) cjson_alloc(allocator, sizeof(CJsonObject));
-    obj->_slots = k_default_hash_table_size;
-    obj->_data = (CJsonObjectNode**) cjson_alloc(allocator, (obj->_slots + 1) * sizeof(CJsonObjectNode*));
+    CJsonObject* obj = (CJsonObject*) cjson_alloc_kind(allocator, sizeof(CJsonObject), cjson_object_allocation);
+    obj->_slots = CJSON_MAX(capacity, 1);
+    obj->_data = (CJsonObjectNode**) cjson_alloc_kind(allocator, (obj->_slots + 1) * sizeof(CJsonObjectNode*), cjson_object_allocation);
     obj->_allocator = allocator;
     memset(obj->_data, 0, (obj->_slots + 1) * sizeof(CJsonObjectNode*));
     obj->_data[obj->_slots] = cjson_impl_object_end_marker_new(obj->_allocator);
@@ -121,6 +126,19 @@ CJsonObject* cjson_object_new(CJsonAllocator* allocator) {
 }
 
 void cjson_object_free(CJsonObject* this) {
+    CJsonImplValueStack pending;
+    cjson_impl_value_stack_init(&pending);
+    cjson_impl_object_free_deferred(this, &pending);
+    cjson_impl_value_stack_drain(&pending);
+}
+
+void cjson_impl_object_free_deferred(CJsonObject* this, CJsonImplValueStack* pending) {
+    for(size_t i = 0; i != this->_slots; ++i) {
+        for(CJsonObjectNode* node = this->_data[i]; node != NULL; node = node->next) {
+            cjson_impl_value_free_deferred(node->val, pending);
+            node->val = NULL;
+        }
+    }
     for(size_t i = 0; i != this->_slots; ++i) {
         cjson_object_node_free_block(this->_data[i]);
     }
@@ -243,19 +261,23 @@ bool cjson_object_equals(CJsonObject* this, CJsonObject* other) {
     return true;
 }
 
+size_t cjson_object_arena_size(size_t capacity) {
+    const size_t slots = CJSON_MAX(capacity, 1);
+    return cjson_linear_allocator_block_size(sizeof(CJsonObject))
+        + cjson_linear_allocator_block_size((slots + 1) * sizeof(CJsonObjectNode*))
+        + cjson_object_member_arena_size(0);
+}
+
+size_t cjson_object_member_arena_size(size_t key_length) {
+    return cjson_linear_allocator_block_size(sizeof(CJsonObjectNode))
+        + cjson_linear_allocator_block_size(key_length + 1);
+}
+
 void cjson_object_fmt(CJsonStringStream* stream, CJsonObject* this) {
-    cjson_string_stream_write(stream, "{");
-    CJsonObjectIterator it = cjson_object_iter_begin(this);
-    while(!cjson_object_iter_is_end(it)) {
-        cjson_raw_str_fmt(stream, it->key);
-        cjson_string_stream_write(stream, ": ");
-        cjson_value_fmt(stream, it->val);
-        it = cjson_object_iter_next(it);
-        if(!cjson_object_iter_is_end(it)) {
-            cjson_string_stream_write(stream, ", ");
-        }
-    }
-    cjson_string_stream_write(stream, "}");
+    CJsonSink sink;
+    cjson_string_stream_sink_init(&sink, stream);
+    const CJsonWriteOptions options = cjson_write_options_default();
+    cjson_impl_write_object(&sink, this, &options, 0);
 }
 
 CJsonObject* cjson_impl_object_builder(CJsonAllocator* allocator, size_t items, ...) {
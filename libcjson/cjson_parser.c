@@ -0,0 +1,574 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_allocator.h"
+#include "cjson_array.h"
+#include "cjson_buffer.h"
+#include "cjson_object.h"
+#include "cjson_parser.h"
+#include "cjson_scanner.h"
+#include "cjson_str.h"
+#include "cjson_tokenizer.h"
+#include "cjson_utils.h"
+#include "cjson_value.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CJSON_PARSER_INITIAL_DEPTH
+#define CJSON_PARSER_INITIAL_DEPTH 32
+#endif
+
+#ifndef CJSON_PARSER_INITIAL_BUFFER_SIZE
+#define CJSON_PARSER_INITIAL_BUFFER_SIZE 256
+#endif
+
+#ifndef CJSON_PARSER_POOL_SIZE
+#define CJSON_PARSER_POOL_SIZE 4
+#endif
+
+
+// Token whose end was not part of the last chunk.
+typedef enum CJsonParserPendingToken {
+    cjson_parser_no_pending_token = 0,
+    cjson_parser_pending_string_token,
+    cjson_parser_pending_scalar_token
+} CJsonParserPendingToken;
+
+typedef struct CJsonImplParser {
+    CJsonSyntaxState state;
+    CJsonValue* root;
+    // Containers being filled, innermost last. They are attached to their parent as soon as
+    // they open, so that the partial tree is always reachable from the root.
+    CJsonValue** stack;
+    size_t depth;
+    size_t stack_capacity;
+    // Key of the object member whose value comes next.
+    CJsonBuffer* key;
+    CJsonParserPendingToken pending_token;
+    CJsonBuffer* pending;
+    size_t pending_size;
+    bool pending_escape;
+    size_t offset;
+    size_t max_depth;
+    CJsonParserLimits limits;
+    CJsonParseError error;
+    // Values and bytes of the tree so far, charged against the limits.
+    size_t values;
+    size_t memory;
+    bool lazy;
+    // Strings borrow the input, which belongs to the caller and may be written to.
+    bool in_situ;
+    // Element counts of the containers to come, in the order they open.
+    const size_t* container_sizes;
+    size_t container_count;
+    size_t next_container;
+    // The parser's own memory, which outlives the documents it reads.
+    CJsonAllocator* scratch_allocator;
+} CJsonImplParser;
+
+CJsonImplParser* cjson_impl_parser_new(CJsonAllocator* allocator) {
+    CJsonImplParser* this = (CJsonImplParser*) cjson_alloc_kind(allocator, sizeof(CJsonImplParser), cjson_reader_allocation);
+    this->state = cjson_syntax_value_state;
+    this->root = NULL;
+    this->stack = (CJsonValue**) cjson_alloc_kind(allocator, CJSON_PARSER_INITIAL_DEPTH * sizeof(CJsonValue*), cjson_reader_allocation);
+    this->depth = 0;
+    this->stack_capacity = CJSON_PARSER_INITIAL_DEPTH;
+    this->key = cjson_buffer_new(CJSON_PARSER_INITIAL_BUFFER_SIZE, allocator);
+    this->pending_token = cjson_parser_no_pending_token;
+    this->pending = cjson_buffer_new(CJSON_PARSER_INITIAL_BUFFER_SIZE, allocator);
+    this->pending_size = 0;
+    this->pending_escape = false;
+    this->offset = 0;
+    this->max_depth = 0;
+    memset(&this->limits, 0, sizeof(CJsonParserLimits));
+    this->error = cjson_no_parse_error;
+    this->values = 0;
+    this->memory = 0;
+    this->lazy = false;
+    this->in_situ = false;
+    this->container_sizes = NULL;
+    this->container_count = 0;
+    this->next_container = 0;
+    this->scratch_allocator = allocator;
+    return this;
+}
+
+void cjson_impl_parser_discard_tree(CJsonImplParser* this, CJsonAllocator* allocator) {
+    if(this->root != NULL && !cjson_allocator_has_bulk_free(allocator)) {
+        cjson_value_free(this->root);
+    }
+    this->root = NULL;
+    this->depth = 0;
+}
+
+void cjson_impl_parser_free(CJsonImplParser* this, CJsonAllocator* allocator) {
+    cjson_impl_parser_discard_tree(this, allocator);
+    cjson_buffer_free(this->pending);
+    cjson_buffer_free(this->key);
+    cjson_dealloc(this->scratch_allocator, this->stack);
+    cjson_dealloc(this->scratch_allocator, this);
+}
+
+void cjson_impl_parser_reset(CJsonImplParser* this, CJsonAllocator* allocator) {
+    cjson_impl_parser_discard_tree(this, allocator);
+    this->state = cjson_syntax_value_state;
+    this->pending_token = cjson_parser_no_pending_token;
+    this->pending_size = 0;
+    this->pending_escape = false;
+    this->offset = 0;
+    this->error = cjson_no_parse_error;
+    this->values = 0;
+    this->memory = 0;
+    this->container_sizes = NULL;
+    this->container_count = 0;
+    this->next_container = 0;
+}
+
+bool cjson_impl_parser_fail(CJsonImplParser* this, CJsonAllocator* allocator, size_t offset) {
+    cjson_impl_parser_discard_tree(this, allocator);
+    this->state = cjson_syntax_error_state;
+    this->offset = offset;
+    if(this->error == cjson_no_parse_error) {
+        this->error = cjson_syntax_parse_error;
+    }
+    return false;
+}
+
+bool cjson_impl_parser_exceed(CJsonImplParser* this, CJsonParseError error) {
+    this->error = error;
+    return false;
+}
+
+// Charges `values` values taking `size` bytes to the tree. False once a budget is exceeded.
+bool cjson_impl_parser_charge(CJsonImplParser* this, size_t values, size_t size) {
+    this->values += values;
+    this->memory += size;
+    if(this->limits.max_values != 0 && this->values > this->limits.max_values) {
+        return cjson_impl_parser_exceed(this, cjson_value_count_parse_error);
+    }
+    if(this->limits.max_memory != 0 && this->memory > this->limits.max_memory) {
+        return cjson_impl_parser_exceed(this, cjson_memory_parse_error);
+    }
+    return true;
+}
+
+// Charges a value about to be added to the tree, taking `size` bytes besides the value itself
+// and its slot in the enclosing container.
+bool cjson_impl_parser_charge_value(CJsonImplParser* this, size_t size) {
+    const size_t slot_size = this->depth > 0 ? sizeof(CJsonValue*) : 0;
+    return cjson_impl_parser_charge(this, 1, sizeof(CJsonValue) + slot_size + size);
+}
+
+bool cjson_impl_parser_check_length(CJsonImplParser* this, size_t length) {
+    if(this->limits.max_string_length != 0 && length > this->limits.max_string_length) {
+        return cjson_impl_parser_exceed(this, cjson_string_length_parse_error);
+    }
+    return true;
+}
+
+void cjson_impl_parser_buffer_assign(CJsonBuffer* buffer, size_t offset, const char* data, size_t size) {
+    // One extra byte keeps room for a terminating NUL.
+    const size_t required_size = offset + size + 1;
+    if(required_size > buffer->size) {
+        cjson_buffer_resize(buffer, CJSON_MAX(buffer->size * 2, required_size));
+    }
+    memcpy(buffer->buffer + offset, data, size * sizeof(char));
+    buffer->buffer[offset + size] = '\0';
+}
+
+// False when the token outgrows the length budget, which keeps the pending buffer bounded.
+bool cjson_impl_parser_stash(CJsonImplParser* this, const char* data, size_t size) {
+    if(!cjson_impl_parser_check_length(this, this->pending_size + size)) { return false; }
+    cjson_impl_parser_buffer_assign(this->pending, this->pending_size, data, size);
+    this->pending_size += size;
+    return true;
+}
+
+void cjson_impl_parser_insert(CJsonImplParser* this, CJsonValue* value) {
+    this->state = cjson_syntax_after_value(this->depth);
+    if(this->depth == 0) {
+        this->root = value;
+        return;
+    }
+    CJsonValue* container = this->stack[this->depth - 1];
+    if(cjson_value_is_object(container)) {
+        cjson_object_set(cjson_value_get_object(container), this->key->buffer, value);
+    }
+    else {
+        cjson_array_push(cjson_value_get_array(container), value);
+    }
+}
+
+CJsonValue* cjson_impl_parser_new_container(CJsonImplParser* this, CJsonAllocator* allocator, bool is_object) {
+    if(this->next_container < this->container_count) {
+        const size_t capacity = this->container_sizes[this->next_container++];
+        return is_object
+            ? cjson_value_new_as_object(cjson_object_new_with_capacity(capacity, allocator), allocator)
+            : cjson_value_new_as_array(cjson_array_new_with_capacity(capacity, allocator), allocator);
+    }
+    return is_object
+        ? cjson_value_new_as_object(cjson_object_new(allocator), allocator)
+        : cjson_value_new_as_array(cjson_array_new(allocator), allocator);
+}
+
+bool cjson_impl_parser_open(CJsonImplParser* this, CJsonAllocator* allocator, bool is_object) {
+    if(!cjson_syntax_expects_value(this->state)) { return false; }
+    if(this->max_depth != 0 && this->depth == this->max_depth) {
+        return cjson_impl_parser_exceed(this, cjson_depth_parse_error);
+    }
+    if(!cjson_impl_parser_charge_value(this, is_object ? sizeof(CJsonObject) : sizeof(CJsonArray))) { return false; }
+    CJsonValue* value = cjson_impl_parser_new_container(this, allocator, is_object);
+    cjson_impl_parser_insert(this, value);
+    if(this->depth == this->stack_capacity) {
+        this->stack_capacity *= 2;
+        this->stack = (CJsonValue**) cjson_realloc(this->scratch_allocator, this->stack, this->stack_capacity * sizeof(CJsonValue*));
+    }
+    this->stack[this->depth++] = value;
+    this->state = cjson_syntax_after_open(is_object);
+    return true;
+}
+
+bool cjson_impl_parser_close(CJsonImplParser* this, bool is_object) {
+    if(this->depth == 0 || cjson_value_is_object(this->stack[this->depth - 1]) != is_object) { return false; }
+    if(!cjson_syntax_can_close(this->state, is_object)) { return false; }
+    --this->depth;
+    this->state = cjson_syntax_after_value(this->depth);
+    return true;
+}
+
+bool cjson_impl_parser_comma(CJsonImplParser* this) {
+    if(this->state != cjson_syntax_separator_state) { return false; }
+    this->state = cjson_syntax_after_comma(cjson_value_is_object(this->stack[this->depth - 1]));
+    return true;
+}
+
+bool cjson_impl_parser_colon(CJsonImplParser* this) {
+    if(this->state != cjson_syntax_colon_state) { return false; }
+    this->state = cjson_syntax_value_state;
+    return true;
+}
+
+// Tokens carried over from a previous chunk live in the pending buffer, which is reused: only
+// tokens read straight from the caller's input can stay lazy or be borrowed.
+bool cjson_impl_parser_is_input(const CJsonImplParser* this, const char* data) {
+    return data != this->pending->buffer;
+}
+
+// Decodes the escape sequences of a string into the pending buffer, or in place when the string
+// already lies there. Returns NULL on a malformed escape sequence.
+const char* cjson_impl_parser_unescape(CJsonImplParser* this, const char* data, size_t size, size_t* out_size) {
+    if(!cjson_tokenizer_has_escape(data, size)) {
+        *out_size = size;
+        return data;
+    }
+    if(cjson_impl_parser_is_input(this, data)) {
+        cjson_impl_parser_buffer_assign(this->pending, 0, data, size);
+    }
+    char* buffer = this->pending->buffer;
+    return cjson_tokenizer_unescape(buffer, size, buffer, out_size) ? buffer : NULL;
+}
+
+CJsonValue* cjson_impl_parser_new_str(CJsonImplParser* this, CJsonAllocator* allocator, const char* data, size_t size) {
+    const bool is_input = cjson_impl_parser_is_input(this, data);
+    if(is_input && this->in_situ) {
+        char* in_situ = (char*) data;
+        size_t length = size;
+        if(cjson_tokenizer_has_escape(data, size) && !cjson_tokenizer_unescape(data, size, in_situ, &length)) {
+            return NULL;
+        }
+        // The closing quote, or a byte freed by decoding, makes room for the terminating NUL.
+        in_situ[length] = '\0';
+        return cjson_value_new_as_str(cjson_str_new_view(in_situ, length, allocator), allocator);
+    }
+    if(is_input && this->lazy && !cjson_tokenizer_has_escape(data, size)) {
+        return cjson_value_new_as_lazy_str(data, size, allocator);
+    }
+    size_t length = 0;
+    const char* content = cjson_impl_parser_unescape(this, data, size, &length);
+    if(content == NULL) { return NULL; }
+    return cjson_value_new_as_str(cjson_str_new_from_bytes(content, length, allocator), allocator);
+}
+
+bool cjson_impl_parser_string(CJsonImplParser* this, CJsonAllocator* allocator, const char* data, size_t size) {
+    if(!cjson_impl_parser_check_length(this, size)) { return false; }
+    if(cjson_syntax_expects_key(this->state)) {
+        if(!cjson_impl_parser_charge(this, 0, size + 1)) { return false; }
+        cjson_impl_parser_buffer_assign(this->key, 0, data, size);
+        char* key = this->key->buffer;
+        size_t length = size;
+        if(cjson_tokenizer_has_escape(key, size) && !cjson_tokenizer_unescape(key, size, key, &length)) { return false; }
+        key[length] = '\0';
+        this->state = cjson_syntax_colon_state;
+        return true;
+    }
+    if(!cjson_syntax_expects_value(this->state)) { return false; }
+    if(!cjson_impl_parser_charge_value(this, sizeof(CJsonStr) + size + 1)) { return false; }
+    CJsonValue* value = cjson_impl_parser_new_str(this, allocator, data, size);
+    if(value == NULL) { return false; }
+    cjson_impl_parser_insert(this, value);
+    return true;
+}
+
+bool cjson_impl_parser_scalar(CJsonImplParser* this, CJsonAllocator* allocator, const char* data, size_t size) {
+    if(!cjson_syntax_expects_value(this->state)) { return false; }
+    if(!cjson_impl_parser_check_length(this, size) || !cjson_impl_parser_charge_value(this, 0)) { return false; }
+    CJsonValue* value = NULL;
+    switch(cjson_tokenizer_classify_scalar(data, size)) {
+        case cjson_null_scalar: { value = cjson_value_new_as_null(allocator); break; }
+        case cjson_true_scalar: { value = cjson_value_new_as_bool(true, allocator); break; }
+        case cjson_false_scalar: { value = cjson_value_new_as_bool(false, allocator); break; }
+        case cjson_number_scalar: {
+            value = this->lazy && cjson_impl_parser_is_input(this, data)
+                ? cjson_value_new_as_lazy_number(data, size, allocator)
+                : cjson_value_new_as_number(cjson_tokenizer_number_value(data, size), allocator);
+            break;
+        }
+        case cjson_invalid_scalar: return false;
+    }
+    cjson_impl_parser_insert(this, value);
+    return true;
+}
+
+bool cjson_impl_parser_complete_pending(CJsonImplParser* this, CJsonAllocator* allocator) {
+    const CJsonParserPendingToken token = this->pending_token;
+    const size_t size = this->pending_size;
+    this->pending_token = cjson_parser_no_pending_token;
+    this->pending_size = 0;
+    this->pending_escape = false;
+    if(token == cjson_parser_pending_string_token) {
+        return cjson_impl_parser_string(this, allocator, this->pending->buffer, size);
+    }
+    return cjson_impl_parser_scalar(this, allocator, this->pending->buffer, size);
+}
+
+// Completes the token left pending by the previous chunk. `cursor` moves to where parsing
+// resumes, or to `end` when the token goes on past this chunk as well.
+bool cjson_impl_parser_resume(CJsonImplParser* this, CJsonAllocator* allocator, const char** cursor, const char* end) {
+    const char* token_start = *cursor;
+    if(this->pending_token == cjson_parser_pending_string_token) {
+        const char* search_start = this->pending_escape ? token_start + 1 : token_start;
+        const char* closing_quote = cjson_scan_string_end(search_start, end);
+        if(closing_quote == NULL) {
+            this->pending_escape = cjson_tokenizer_ends_with_escape(search_start, end);
+            *cursor = end;
+            return cjson_impl_parser_stash(this, token_start, end - token_start);
+        }
+        *cursor = closing_quote + 1;
+        if(!cjson_impl_parser_stash(this, token_start, closing_quote - token_start)) { return false; }
+    }
+    else {
+        const char* scalar_end = cjson_tokenizer_scalar_end(token_start, end);
+        *cursor = scalar_end;
+        if(!cjson_impl_parser_stash(this, token_start, scalar_end - token_start)) { return false; }
+        if(scalar_end == end) { return true; }
+    }
+    return cjson_impl_parser_complete_pending(this, allocator);
+}
+
+bool cjson_impl_parser_feed(CJsonImplParser* this, CJsonAllocator* allocator, const char* chunk, size_t size) {
+    if(this->state == cjson_syntax_error_state) { return false; }
+    if(this->limits.max_size != 0 && size > this->limits.max_size - this->offset) {
+        cjson_impl_parser_exceed(this, cjson_size_parse_error);
+        return cjson_impl_parser_fail(this, allocator, this->limits.max_size);
+    }
+    const char* cursor = chunk;
+    const char* const end = chunk + size;
+    if(this->pending_token != cjson_parser_no_pending_token && cursor != end
+       && !cjson_impl_parser_resume(this, allocator, &cursor, end)) {
+        return cjson_impl_parser_fail(this, allocator, this->offset + (cursor - chunk));
+    }
+    while(cursor != end) {
+        const char* token_start = cursor;
+        bool accepted = true;
+        switch(cjson_char_class(*cursor)) {
+            case cjson_blank_char: ++cursor; continue;
+            case cjson_left_brace_char: accepted = cjson_impl_parser_open(this, allocator, true); ++cursor; break;
+            case cjson_left_bracket_char: accepted = cjson_impl_parser_open(this, allocator, false); ++cursor; break;
+            case cjson_right_brace_char: accepted = cjson_impl_parser_close(this, true); ++cursor; break;
+            case cjson_right_bracket_char: accepted = cjson_impl_parser_close(this, false); ++cursor; break;
+            case cjson_comma_char: accepted = cjson_impl_parser_comma(this); ++cursor; break;
+            case cjson_colon_char: accepted = cjson_impl_parser_colon(this); ++cursor; break;
+            case cjson_quote_char: {
+                const char* closing_quote = cjson_scan_string_end(cursor + 1, end);
+                if(closing_quote == NULL) {
+                    this->pending_token = cjson_parser_pending_string_token;
+                    this->pending_escape = cjson_tokenizer_ends_with_escape(cursor + 1, end);
+                    accepted = cjson_impl_parser_stash(this, cursor + 1, end - cursor - 1);
+                    cursor = end;
+                    break;
+                }
+                accepted = cjson_impl_parser_string(this, allocator, cursor + 1, closing_quote - cursor - 1);
+                if(accepted) { cursor = closing_quote + 1; }
+                break;
+            }
+            case cjson_digit_char:
+            case cjson_minus_char:
+            case cjson_scalar_char: {
+                const char* scalar_end = cjson_tokenizer_scalar_end(cursor, end);
+                if(scalar_end == end) {
+                    this->pending_token = cjson_parser_pending_scalar_token;
+                    accepted = cjson_impl_parser_stash(this, cursor, end - cursor);
+                    cursor = end;
+                }
+                else {
+                    accepted = cjson_impl_parser_scalar(this, allocator, cursor, scalar_end - cursor);
+                    if(accepted) { cursor = scalar_end; }
+                }
+                break;
+            }
+            case cjson_other_char: accepted = false; break;
+        }
+        if(!accepted) {
+            return cjson_impl_parser_fail(this, allocator, this->offset + (token_start - chunk));
+        }
+    }
+    this->offset += size;
+    return true;
+}
+
+CJsonValue* cjson_impl_parser_finish(CJsonImplParser* this, CJsonAllocator* allocator) {
+    if(this->state == cjson_syntax_error_state) { return NULL; }
+    if(this->pending_token == cjson_parser_pending_string_token) {
+        cjson_impl_parser_fail(this, allocator, this->offset);
+        return NULL;
+    }
+    if(this->pending_token == cjson_parser_pending_scalar_token
+       && !cjson_impl_parser_complete_pending(this, allocator)) {
+        cjson_impl_parser_fail(this, allocator, this->offset);
+        return NULL;
+    }
+    if(this->state != cjson_syntax_done_state) {
+        cjson_impl_parser_fail(this, allocator, this->offset);
+        return NULL;
+    }
+    CJsonValue* root = this->root;
+    this->root = NULL;
+    return root;
+}
+
+CJsonParser* cjson_parser_new(CJsonAllocator* allocator) {
+    allocator = cjson_allocator_or_default(allocator);
+    CJsonParser* this = (CJsonParser*) cjson_alloc_kind(allocator, sizeof(CJsonParser), cjson_reader_allocation);
+    this->_impl = cjson_impl_parser_new(allocator);
+    this->_allocator = allocator;
+    return this;
+}
+
+void cjson_parser_free(CJsonParser* this) {
+    CJsonAllocator* scratch_allocator = this->_impl->scratch_allocator;
+    cjson_impl_parser_free(this->_impl, this->_allocator);
+    cjson_dealloc(scratch_allocator, this);
+}
+
+void cjson_parser_reset(CJsonParser* this, CJsonAllocator* allocator) {
+    cjson_impl_parser_reset(this->_impl, this->_allocator);
+    this->_allocator = cjson_allocator_or_default(allocator);
+}
+
+void cjson_parser_set_max_depth(CJsonParser* this, size_t max_depth) {
+    this->_impl->max_depth = max_depth;
+}
+
+void cjson_parser_set_limits(CJsonParser* this, const CJsonParserLimits* limits) {
+    if(limits == NULL) {
+        memset(&this->_impl->limits, 0, sizeof(CJsonParserLimits));
+        return;
+    }
+    this->_impl->limits = *limits;
+}
+
+void cjson_parser_set_lazy(CJsonParser* this, bool lazy) {
+    this->_impl->lazy = lazy;
+}
+
+void cjson_impl_parser_presize(CJsonParser* this, const size_t* container_sizes, size_t count) {
+    this->_impl->container_sizes = container_sizes;
+    this->_impl->container_count = count;
+    this->_impl->next_container = 0;
+}
+
+bool cjson_parser_feed(CJsonParser* this, const char* chunk, size_t size) {
+    return cjson_impl_parser_feed(this->_impl, this->_allocator, chunk, size);
+}
+
+CJsonValue* cjson_parser_finish(CJsonParser* this) {
+    return cjson_impl_parser_finish(this->_impl, this->_allocator);
+}
+
+CJsonValue* cjson_parser_read(CJsonParser* this, const char* data, size_t size) {
+    cjson_parser_feed(this, data, size);
+    return cjson_parser_finish(this);
+}
+
+CJsonValue* cjson_impl_parser_read_in_situ(CJsonParser* this, char* data, size_t size) {
+    this->_impl->in_situ = true;
+    CJsonValue* value = cjson_parser_read(this, data, size);
+    this->_impl->in_situ = false;
+    return value;
+}
+
+size_t cjson_parser_offset(const CJsonParser* this) {
+    return this->_impl->offset;
+}
+
+bool cjson_parser_failed(const CJsonParser* this) {
+    return this->_impl->state == cjson_syntax_error_state;
+}
+
+CJsonParseError cjson_parser_error(const CJsonParser* this) {
+    return this->_impl->error;
+}
+
+// Idle parsers of the calling thread, released when the thread exits.
+typedef struct CJsonParserPool {
+    CJsonParser* parsers[CJSON_PARSER_POOL_SIZE];
+    size_t size;
+    bool registered;
+} CJsonParserPool;
+
+static _Thread_local CJsonParserPool t_parser_pool = { .size = 0, .registered = false };
+static pthread_key_t s_parser_pool_key;
+static pthread_once_t s_parser_pool_key_once = PTHREAD_ONCE_INIT;
+
+void cjson_impl_parser_pool_clear(void* pool) {
+    CJsonParserPool* this = (CJsonParserPool*) pool;
+    while(this->size > 0) {
+        cjson_parser_free(this->parsers[--this->size]);
+    }
+}
+
+void cjson_impl_parser_pool_create_key() {
+    pthread_key_create(&s_parser_pool_key, cjson_impl_parser_pool_clear);
+}
+
+CJsonParser* cjson_parser_acquire() {
+    if(t_parser_pool.size > 0) {
+        return t_parser_pool.parsers[--t_parser_pool.size];
+    }
+    return cjson_parser_new(NULL);
+}
+
+void cjson_parser_release(CJsonParser* this) {
+    // Parsers whose scratch state comes from another allocator may not outlive it.
+    if(t_parser_pool.size == CJSON_PARSER_POOL_SIZE || this->_impl->scratch_allocator != cjson_allocator_get_default()) {
+        cjson_parser_free(this);
+        return;
+    }
+    cjson_parser_reset(this, NULL);
+    cjson_parser_set_max_depth(this, 0);
+    cjson_parser_set_limits(this, NULL);
+    cjson_parser_set_lazy(this, false);
+    if(!t_parser_pool.registered) {
+        pthread_once(&s_parser_pool_key_once, cjson_impl_parser_pool_create_key);
+        pthread_setspecific(s_parser_pool_key, &t_parser_pool);
+        t_parser_pool.registered = true;
+    }
+    t_parser_pool.parsers[t_parser_pool.size++] = this;
+}
+
+void cjson_parser_pool_clear() {
+    cjson_impl_parser_pool_clear(&t_parser_pool);
+}
@@ -0,0 +1,303 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_projection.h"
+#include "cjson_allocator.h"
+#include "cjson_array.h"
+#include "cjson_buffer.h"
+#include "cjson_cursor.h"
+#include "cjson_object.h"
+#include "cjson_parser.h"
+#include "cjson_scanner.h"
+#include "cjson_tokenizer.h"
+
+#include <stdint.h>
+#include <string.h>
+
+
+// The paths are merged into a tree of reference tokens: a value is walked along with the node
+// of the tree it matches, and kept whole once it reaches a selected node.
+typedef struct CJsonProjectionNode {
+    char* token;
+    size_t length;
+    // Array index the token designates, SIZE_MAX when it is not one.
+    size_t index;
+    struct CJsonProjectionNode** children;
+    size_t child_count;
+    struct CJsonProjectionNode* wildcard;
+    bool selected;
+} CJsonProjectionNode;
+
+typedef struct CJsonProjection {
+    CJsonParser* parser;
+    CJsonBuffer* key;
+    CJsonAllocator* allocator;
+} CJsonProjection;
+
+size_t cjson_impl_projection_token_index(const char* token, size_t length) {
+    if(length == 0 || (length > 1 && token[0] == '0')) { return SIZE_MAX; }
+    size_t index = 0;
+    for(size_t i = 0; i < length; ++i) {
+        if(token[i] < '0' || token[i] > '9' || index > (SIZE_MAX - 10) / 10) { return SIZE_MAX; }
+        index = index * 10 + (token[i] - '0');
+    }
+    return index;
+}
+
+CJsonProjectionNode* cjson_impl_projection_node_new(const char* token, size_t length) {
+    CJsonProjectionNode* this = (CJsonProjectionNode*) cjson_alloc(NULL, sizeof(CJsonProjectionNode));
+    this->token = (char*) cjson_alloc(NULL, length + 1);
+    memcpy(this->token, token, length);
+    this->token[length] = '\0';
+    this->length = length;
+    this->index = cjson_impl_projection_token_index(token, length);
+    this->children = NULL;
+    this->child_count = 0;
+    this->wildcard = NULL;
+    this->selected = false;
+    return this;
+}
+
+void cjson_impl_projection_node_free(CJsonProjectionNode* this) {
+    if(this == NULL) { return; }
+    for(size_t i = 0; i < this->child_count; ++i) {
+        cjson_impl_projection_node_free(this->children[i]);
+    }
+    cjson_impl_projection_node_free(this->wildcard);
+    cjson_dealloc(NULL, this->children);
+    cjson_dealloc(NULL, this->token);
+    cjson_dealloc(NULL, this);
+}
+
+CJsonProjectionNode* cjson_impl_projection_node_child(CJsonProjectionNode* this, const char* token, size_t length) {
+    if(length == 1 && token[0] == '*') {
+        if(this->wildcard == NULL) { this->wildcard = cjson_impl_projection_node_new(token, length); }
+        return this->wildcard;
+    }
+    for(size_t i = 0; i < this->child_count; ++i) {
+        CJsonProjectionNode* child = this->children[i];
+        if(child->length == length && memcmp(child->token, token, length) == 0) { return child; }
+    }
+    this->children = (CJsonProjectionNode**) cjson_realloc(NULL, this->children, (this->child_count + 1) * sizeof(CJsonProjectionNode*));
+    CJsonProjectionNode* child = cjson_impl_projection_node_new(token, length);
+    this->children[this->child_count++] = child;
+    return child;
+}
+
+// Adds the path of `pointer` under `this`, decoding the `~1` and `~0` escapes of every token.
+bool cjson_impl_projection_node_add(CJsonProjectionNode* this, const char* pointer) {
+    if(*pointer == '\0') {
+        this->selected = true;
+        return true;
+    }
+    if(*pointer != '/') { return false; }
+    const size_t pointer_size = strlen(pointer);
+    char* token = (char*) cjson_alloc(NULL, pointer_size);
+    CJsonProjectionNode* node = this;
+    const char* cursor = pointer + 1;
+    bool is_valid = true;
+    for(;;) {
+        size_t length = 0;
+        for(; *cursor != '\0' && *cursor != '/'; ++cursor) {
+            if(*cursor != '~') {
+                token[length++] = *cursor;
+                continue;
+            }
+            ++cursor;
+            if(*cursor != '0' && *cursor != '1') {
+                is_valid = false;
+                break;
+            }
+            token[length++] = *cursor == '0' ? '~' : '/';
+        }
+        if(!is_valid) { break; }
+        node = cjson_impl_projection_node_child(node, token, length);
+        if(*cursor == '\0') { break; }
+        ++cursor;
+    }
+    cjson_dealloc(NULL, token);
+    if(is_valid) { node->selected = true; }
+    return is_valid;
+}
+
+void cjson_impl_projection_node_merge(CJsonProjectionNode* this, const CJsonProjectionNode* other) {
+    this->selected = this->selected || other->selected;
+    for(size_t i = 0; i < other->child_count; ++i) {
+        const CJsonProjectionNode* child = other->children[i];
+        cjson_impl_projection_node_merge(cjson_impl_projection_node_child(this, child->token, child->length), child);
+    }
+    if(other->wildcard != NULL) {
+        cjson_impl_projection_node_merge(cjson_impl_projection_node_child(this, "*", 1), other->wildcard);
+    }
+}
+
+// Copies what a wildcard selects into its named siblings, so that a member or an element only
+// ever has to be matched against a single node.
+void cjson_impl_projection_node_spread_wildcards(CJsonProjectionNode* this) {
+    for(size_t i = 0; i < this->child_count; ++i) {
+        if(this->wildcard != NULL) { cjson_impl_projection_node_merge(this->children[i], this->wildcard); }
+        cjson_impl_projection_node_spread_wildcards(this->children[i]);
+    }
+    if(this->wildcard != NULL) { cjson_impl_projection_node_spread_wildcards(this->wildcard); }
+}
+
+const CJsonProjectionNode* cjson_impl_projection_node_match_key(const CJsonProjectionNode* this, const char* key, size_t length) {
+    for(size_t i = 0; i < this->child_count; ++i) {
+        const CJsonProjectionNode* child = this->children[i];
+        if(child->length == length && memcmp(child->token, key, length) == 0) { return child; }
+    }
+    return this->wildcard;
+}
+
+const CJsonProjectionNode* cjson_impl_projection_node_match_index(const CJsonProjectionNode* this, size_t index) {
+    for(size_t i = 0; i < this->child_count; ++i) {
+        if(this->children[i]->index == index) { return this->children[i]; }
+    }
+    return this->wildcard;
+}
+
+// Decodes the member key `data` into the key buffer, NUL terminated. Returns NULL on a malformed
+// escape sequence.
+const char* cjson_impl_projection_key(CJsonProjection* this, const char* data, size_t size, size_t* length) {
+    if(this->key->size <= size) { cjson_buffer_resize(this->key, size + 1); }
+    char* key = this->key->buffer;
+    memcpy(key, data, size);
+    *length = size;
+    if(cjson_tokenizer_has_escape(key, size) && !cjson_tokenizer_unescape(key, size, key, length)) { return NULL; }
+    key[*length] = '\0';
+    return key;
+}
+
+const char* cjson_impl_project_value(CJsonProjection* this, const CJsonProjectionNode* node, const char* cursor, const char* end, CJsonValue** projected);
+
+const char* cjson_impl_project_selected(CJsonProjection* this, const char* cursor, const char* end, CJsonValue** projected) {
+    const char* value_end = cjson_impl_cursor_skip_value(cursor, end);
+    if(value_end == NULL) { return NULL; }
+    cjson_parser_reset(this->parser, this->allocator);
+    *projected = cjson_parser_read(this->parser, cursor, value_end - cursor);
+    return *projected == NULL ? NULL : value_end;
+}
+
+const char* cjson_impl_project_object(CJsonProjection* this, const CJsonProjectionNode* node, const char* cursor, const char* end, CJsonValue** projected) {
+    CJsonObject* object = NULL;
+    cursor = cjson_tokenizer_skip_blank(cursor + 1, end);
+    if(cursor != end && *cursor == '}') { return cursor + 1; }
+    for(;;) {
+        if(cursor == end || *cursor != '"') { break; }
+        const char* key = cursor + 1;
+        const char* closing_quote = cjson_scan_string_end(key, end);
+        if(closing_quote == NULL) { break; }
+        const char* colon = cjson_impl_cursor_expect(closing_quote + 1, end, ':');
+        if(colon == NULL) { break; }
+        const char* value = cjson_tokenizer_skip_blank(colon + 1, end);
+        const size_t raw_key_length = closing_quote - key;
+        const char* match_key = key;
+        size_t key_length = raw_key_length;
+        if(cjson_tokenizer_has_escape(key, raw_key_length)) {
+            match_key = cjson_impl_projection_key(this, key, raw_key_length, &key_length);
+            if(match_key == NULL) { break; }
+        }
+        const CJsonProjectionNode* child = cjson_impl_projection_node_match_key(node, match_key, key_length);
+        CJsonValue* member = NULL;
+        const char* value_end = child == NULL
+            ? cjson_impl_cursor_skip_value(value, end)
+            : cjson_impl_project_value(this, child, value, end, &member);
+        if(value_end == NULL) { break; }
+        if(member != NULL) {
+            // Nested objects reuse the key buffer: the key is decoded again once its value is read.
+            if(object == NULL) { object = cjson_object_new(this->allocator); }
+            cjson_object_set(object, cjson_impl_projection_key(this, key, raw_key_length, &key_length), member);
+        }
+        cursor = cjson_tokenizer_skip_blank(value_end, end);
+        if(cursor != end && *cursor == '}') {
+            if(object != NULL) { *projected = cjson_value_new_as_object(object, this->allocator); }
+            return cursor + 1;
+        }
+        if(cursor == end || *cursor != ',') { break; }
+        cursor = cjson_tokenizer_skip_blank(cursor + 1, end);
+    }
+    if(object != NULL) { cjson_object_free(object); }
+    return NULL;
+}
+
+const char* cjson_impl_project_array(CJsonProjection* this, const CJsonProjectionNode* node, const char* cursor, const char* end, CJsonValue** projected) {
+    CJsonArray* array = NULL;
+    cursor = cjson_tokenizer_skip_blank(cursor + 1, end);
+    if(cursor != end && *cursor == ']') { return cursor + 1; }
+    for(size_t index = 0;; ++index) {
+        const CJsonProjectionNode* child = cjson_impl_projection_node_match_index(node, index);
+        CJsonValue* element = NULL;
+        const char* value_end = child == NULL
+            ? cjson_impl_cursor_skip_value(cursor, end)
+            : cjson_impl_project_value(this, child, cursor, end, &element);
+        if(value_end == NULL) { break; }
+        if(element != NULL) {
+            if(array == NULL) { array = cjson_array_new(this->allocator); }
+            cjson_array_push(array, element);
+        }
+        cursor = cjson_tokenizer_skip_blank(value_end, end);
+        if(cursor != end && *cursor == ']') {
+            if(array != NULL) { *projected = cjson_value_new_as_array(array, this->allocator); }
+            return cursor + 1;
+        }
+        if(cursor == end || *cursor != ',') { break; }
+        cursor = cjson_tokenizer_skip_blank(cursor + 1, end);
+    }
+    if(array != NULL) { cjson_array_free(array); }
+    return NULL;
+}
+
+// Returns the end of the value at `cursor`, NULL when malformed. `projected` receives the part of
+// the value selected by `node`, and is left untouched when nothing in it is.
+const char* cjson_impl_project_value(CJsonProjection* this, const CJsonProjectionNode* node, const char* cursor, const char* end, CJsonValue** projected) {
+    if(node->selected) { return cjson_impl_project_selected(this, cursor, end, projected); }
+    if(cursor == end) { return NULL; }
+    switch(*cursor) {
+        case '{': return cjson_impl_project_object(this, node, cursor, end, projected);
+        case '[': return cjson_impl_project_array(this, node, cursor, end, projected);
+        default: return cjson_impl_cursor_skip_value(cursor, end);
+    }
+}
+
+CJsonValue* cjson_impl_projection_empty_root(const char* root, CJsonAllocator* allocator) {
+    switch(*root) {
+        case '{': return cjson_value_new_as_object(cjson_object_new(allocator), allocator);
+        case '[': return cjson_value_new_as_array(cjson_array_new(allocator), allocator);
+        default: return cjson_value_new_as_null(allocator);
+    }
+}
+
+CJsonValue* cjson_read_projected(const char* data, size_t size, const char* const* paths, size_t count, CJsonAllocator* allocator) {
+    CJsonProjectionNode* root = cjson_impl_projection_node_new("", 0);
+    for(size_t i = 0; i < count; ++i) {
+        if(!cjson_impl_projection_node_add(root, paths[i])) {
+            cjson_impl_projection_node_free(root);
+            return NULL;
+        }
+    }
+    cjson_impl_projection_node_spread_wildcards(root);
+
+    CJsonProjection projection = {
+        .parser = cjson_parser_acquire(),
+        .key = cjson_buffer_new(64, NULL),
+        .allocator = allocator
+    };
+    const char* const end = data + size;
+    const char* cursor = cjson_tokenizer_skip_blank(data, end);
+    CJsonValue* projected = NULL;
+    const char* value_end = cjson_impl_project_value(&projection, root, cursor, end, &projected);
+    if(value_end != NULL && cjson_tokenizer_skip_blank(value_end, end) != end) { value_end = NULL; }
+    if(value_end == NULL && projected != NULL) {
+        cjson_value_free(projected);
+        projected = NULL;
+    }
+    else if(value_end != NULL && projected == NULL) {
+        projected = cjson_impl_projection_empty_root(cursor, allocator);
+    }
+
+    cjson_buffer_free(projection.key);
+    cjson_parser_release(projection.parser);
+    cjson_impl_projection_node_free(root);
+    return projected;
+}
@@ -6,434 +6,337 @@
 //  Copyright © 2020 Jean-Edouard BOULANGER. All rights reserved.
 //
 
+#define _GNU_SOURCE
+
 #include "cjson_allocator.h"
 #include "cjson_array.h"
 #include "cjson_object.h"
+#include "cjson_parser.h"
 #include "cjson_reader.h"
+#include "cjson_scanner.h"
 #include "cjson_str.h"
+#include "cjson_tokenizer.h"
+#include "cjson_utils.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
-#include <ctype.h>
-
-
-const size_t k_default_buffer_size = 16384;
-
-const char PUNCTUATION_TOKEN_MAP[] = {
- /* 000 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 016 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 032 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 10,  0,  0,  0,
- /* 048 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 11,  0,  0,  0,  0,  0,
- /* 064 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 080 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  8,  0,  9,  0,  0,
- /* 096 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 112 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  6,  0,  7,  0,  0,
- /* 128 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 144 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 160 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 176 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 192 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 208 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 224 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 240 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
-};
-
-const char BLANK_TOKEN_MAP[] = {
- /* 000 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  0,  0,  1,  0,  0,
- /* 016 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 032 */  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 048 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 064 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 080 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 096 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 112 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 128 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 144 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 160 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 176 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 192 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 208 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 224 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- /* 240 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
-};
-
-typedef enum TokenType {
-    cjson_null_token = 1,
-    cjson_number_token = 2,
-    cjson_str_token = 3,
-    cjson_true_token = 4,
-    cjson_false_token = 5,
-    cjson_left_brace_token = 6,
-    cjson_right_brace_token = 7,
-    cjson_left_bracket_token = 8,
-    cjson_right_bracket_token = 9,
-    cjson_comma_token = 10,
-    cjson_colon_token = 11
-} TokenType;
-
-const char* const TOKEN_NAMES[] = {
-    "BAD_TOKEN",
-    "NULL_TOKEN",
-    "NUMBER_TOKEN",
-    "STR_TOKEN",
-    "TRUE_TOKEN",
-    "FALSE_TOKEN",
-    "LEFT_BRACE_TOKEN",
-    "RIGHT_BRACE_TOKEN",
-    "LEFT_BRACKET_TOKEN",
-    "RIGHT_BRACKET_TOKEN",
-    "COMMA_TOKEN",
-    "COLON_TOKEN"
-};
-
-typedef struct Token {
-    TokenType type;
-    char* data;
-    char* end;
-} Token;
-
-void token_print(Token* token) {
-    if(token == NULL) {
-        printf("NULL token\n");
-        return;
-    }
-    printf("Token(type=%s, data='%s', end=%p)\n", TOKEN_NAMES[token->type], token->data, token->end);
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef CJSON_READER_FILE_CHUNK_SIZE
+#define CJSON_READER_FILE_CHUNK_SIZE ((size_t) 1 << 16)
+#endif
+
+
+// Element count of every container in the order they open, and the number of bytes the tree
+// built by the reader takes in a linear allocator.
+typedef struct CJsonPrescan {
+    size_t* counts;
+    size_t containers;
+    size_t capacity;
+    size_t arena_size;
+} CJsonPrescan;
+
+typedef struct CJsonPrescanFrame {
+    size_t index;
+    size_t commas;
+    bool is_object;
+    bool has_content;
+} CJsonPrescanFrame;
+
+size_t cjson_prescan_str_arena_size(size_t length) {
+    return cjson_linear_allocator_block_size(sizeof(CJsonStr))
+        + cjson_linear_allocator_block_size(length + 1);
 }
 
-typedef struct TokenizerContext {
-    char* cursor;
-    Token* token;
-    char* buffer;
-    struct CJsonAllocator* allocator;
-} TokenizerContext;
-
-TokenizerContext* tokenizer_new(char* data, size_t buffer_sz, CJsonAllocator* allocator) {
-    allocator = cjson_allocator_or_default(allocator);
-    TokenizerContext* ctx = (TokenizerContext*) cjson_alloc(allocator, sizeof(TokenizerContext));
-    ctx->allocator = allocator;
-    ctx->cursor = data;
-    ctx->buffer = (char*) cjson_alloc(allocator, buffer_sz * sizeof(char));
-    memset(ctx->buffer, 0, buffer_sz * sizeof(char));
-    Token* token = (Token*) cjson_alloc(allocator, sizeof(Token));
-    token->type = cjson_null_token;
-    token->data = ctx->buffer;
-    token->end = ctx->cursor;
-    ctx->token = token;
-    return ctx;
+size_t cjson_prescan_key_arena_size(size_t length) {
+    return cjson_object_member_arena_size(length);
 }
 
-void tokenizer_free(TokenizerContext* this) {
-    cjson_dealloc(this->allocator, this->token);
-    cjson_dealloc(this->allocator, this->buffer);
-    cjson_dealloc(this->allocator, this);
-}
-
-void tokenizer_advance(TokenizerContext* this, size_t bytes) {
-    this->cursor += bytes;
-}
-
-Token* tokenizer_make_token(TokenizerContext* this, TokenType type, const char* data, size_t bytes, char* end) {
-    Token* token = this->token;
-    token->type = type;
-    memcpy(this->buffer, data, bytes * sizeof(char));
-    this->buffer[bytes] = '\0';
-    token->end = end;
-    return token;
+size_t cjson_prescan_container_arena_size(const CJsonPrescanFrame* frame, size_t elements) {
+    const size_t values_size = elements * cjson_linear_allocator_block_size(sizeof(CJsonValue));
+    if(frame->is_object) {
+        return values_size + cjson_object_arena_size(elements);
+    }
+    return values_size
+        + cjson_linear_allocator_block_size(sizeof(CJsonArray))
+        + cjson_linear_allocator_block_size(CJSON_MAX(elements, 1) * sizeof(CJsonValue*));
 }
 
-Token* tokenizer_make_simple_token(TokenizerContext* this, TokenType type, char* end) {
-    Token* token = this->token;
-    token->type = type;
-    this->buffer[0] = '\0';
-    token->end = end;
-    return token;
+bool cjson_prescan_is_blank(const char* begin, const char* end) {
+    return cjson_tokenizer_skip_blank(begin, end) == end;
 }
 
-bool tokenizer_match(TokenizerContext* this, char* what) {
-    char* ptr = this->cursor;
-    size_t read_bytes = 0;
+// Budgets of the read are checked ahead of the parser so that untrusted input cannot make the
+// prescan allocate: its frames grow with the depth and its counts with the containers, which are
+// values. 0 stands for no limit.
+CJsonParseError cjson_prescan_run(CJsonPrescan* this, const char* data, size_t size, size_t max_depth, size_t max_values) {
+    const char* cursor = data;
+    const char* const end = data + size;
+    size_t depth = 0;
+    size_t frames_capacity = 64;
+    CJsonParseError error = cjson_no_parse_error;
+    CJsonPrescanFrame* frames = (CJsonPrescanFrame*) cjson_alloc(NULL, frames_capacity * sizeof(CJsonPrescanFrame));
+    if(frames == NULL) { return cjson_memory_parse_error; }
+    this->arena_size = cjson_linear_allocator_block_size(sizeof(CJsonValue));
     for(;;) {
-        if(*what == '\0') {
-            tokenizer_advance(this, read_bytes);
-            return true;
-        }
-        if(*what != *ptr) { return false; }
-        ++read_bytes;
-        ++what;
-        ++ptr;
-    }
-}
-
-Token* tokenizer_try_tokenize_string(TokenizerContext* this) {
-    char* ptr = this->cursor;
-    if(*ptr++ != '"') { return NULL; }
-    for(;;) {
-        char c = *ptr;
-        if(c == '\0') {
-            break;
-        }
-        else if(c == '\\' && *(ptr + 1) == '"') {
-            ptr += 2;
+        const char* structural = cjson_scan_structural(cursor, end);
+        CJsonPrescanFrame* top = depth > 0 ? &frames[depth - 1] : NULL;
+        if(top != NULL && !top->has_content && !cjson_prescan_is_blank(cursor, structural)) {
+            top->has_content = true;
         }
-        else if(c == '"') {
-            const size_t read_bytes = (ptr - this->cursor) + 1;
-            const size_t str_size = read_bytes - 2;
-            Token* token = tokenizer_make_token(this, cjson_str_token, this->cursor + 1, str_size, ptr + 1);
-            tokenizer_advance(this, read_bytes);
-            return token;
+        if(structural == end) { break; }
+        const char c = *structural;
+        if(c == '"') {
+            const char* closing_quote = cjson_scan_string_end(structural + 1, end);
+            if(closing_quote == NULL) { break; }
+            const size_t length = closing_quote - structural - 1;
+            cursor = closing_quote + 1;
+            cursor = cjson_tokenizer_skip_blank(cursor, end);
+            const bool is_key = cursor != end && *cursor == ':';
+            this->arena_size += is_key ? cjson_prescan_key_arena_size(length) : cjson_prescan_str_arena_size(length);
+            if(top != NULL) { top->has_content = true; }
+            continue;
         }
-        else {
-            ++ptr;
+        if(c == '[' || c == '{') {
+            if(top != NULL) { top->has_content = true; }
+            if(max_depth != 0 && depth == max_depth) {
+                error = cjson_depth_parse_error;
+                break;
+            }
+            if(max_values != 0 && this->containers == max_values) {
+                error = cjson_value_count_parse_error;
+                break;
+            }
+            if(depth == frames_capacity) {
+                CJsonPrescanFrame* grown_frames = (CJsonPrescanFrame*) cjson_realloc(NULL, frames, 2 * frames_capacity * sizeof(CJsonPrescanFrame));
+                if(grown_frames == NULL) {
+                    error = cjson_memory_parse_error;
+                    break;
+                }
+                frames = grown_frames;
+                frames_capacity *= 2;
+            }
+            if(this->containers == this->capacity) {
+                const size_t capacity = CJSON_MAX(this->capacity * 2, 64);
+                size_t* counts = (size_t*) cjson_realloc(NULL, this->counts, capacity * sizeof(size_t));
+                if(counts == NULL) {
+                    error = cjson_memory_parse_error;
+                    break;
+                }
+                this->counts = counts;
+                this->capacity = capacity;
+            }
+            CJsonPrescanFrame* frame = &frames[depth++];
+            frame->index = this->containers++;
+            frame->commas = 0;
+            frame->is_object = c == '{';
+            frame->has_content = false;
         }
-    }
-    return NULL;
-}
-
-Token* tokenizer_try_tokenize_number(TokenizerContext* this) {
-    char* ptr = this->cursor;
-    if(*ptr == '-') { ++ptr; }
-    if(!isdigit(*ptr++)) { return NULL; }
-    while(isdigit(*ptr)) { ++ptr; }
-    
-    if(*ptr == '.') {
-        ++ptr;
-        if(!isdigit(*ptr++)) {
-            return NULL;
+        else if(c == ',') {
+            if(top == NULL) { break; }
+            top->commas += 1;
         }
-        while(isdigit(*ptr)) { ++ptr; }
-    }
-    
-    if(*ptr == 'e' || *ptr == 'E') {
-        ++ptr;
-        if(*ptr == '-' || *ptr == '+') { ++ptr; }
-        if(!isdigit(*ptr++)) {
-            return NULL;
+        else if(c == ']' || c == '}') {
+            if(top == NULL || top->is_object != (c == '}')) { break; }
+            const size_t elements = top->has_content ? top->commas + 1 : 0;
+            this->counts[top->index] = elements;
+            this->arena_size += cjson_prescan_container_arena_size(top, elements);
+            --depth;
         }
-        while(isdigit(*ptr)) { ++ptr; }
+        cursor = structural + 1;
     }
-
-    const size_t read_bytes = (ptr - this->cursor);
-    Token* token = tokenizer_make_token(this, cjson_number_token, this->cursor, read_bytes, ptr + 1);
-    tokenizer_advance(this, read_bytes);
-    return token;
-}
-
-Token* tokenizer_try_tokenize_true(TokenizerContext* this) {
-    if(tokenizer_match(this, "true")) {
-        return tokenizer_make_simple_token(this, cjson_true_token, this->cursor);
+    cjson_dealloc(NULL, frames);
+    if(error == cjson_no_parse_error && (depth != 0 || cursor != end)) {
+        error = cjson_syntax_parse_error;
     }
-    return NULL;
+    return error;
 }
 
-Token* tokenizer_try_tokenize_false(TokenizerContext* this) {
-    if(tokenizer_match(this, "false")) {
-        return tokenizer_make_simple_token(this, cjson_false_token, this->cursor);
-    }
-    return NULL;
-}
-
-Token* tokenizer_try_tokenize_null(TokenizerContext* this) {
-    if(tokenizer_match(this, "null")) {
-        return tokenizer_make_simple_token(this, cjson_null_token, this->cursor);
+CJsonPrescan* cjson_prescan_new(const char* data, size_t size, size_t max_depth, size_t max_values, CJsonParseError* error) {
+    CJsonPrescan* this = (CJsonPrescan*) cjson_alloc(NULL, sizeof(CJsonPrescan));
+    if(this == NULL) {
+        *error = cjson_memory_parse_error;
+        return NULL;
     }
-    return NULL;
-}
-
-Token* tokenizer_try_tokenize_punctuation(TokenizerContext* this) {
-    const int token_type = PUNCTUATION_TOKEN_MAP[(int)*this->cursor];
-    if(token_type == 0) {
+    this->counts = NULL;
+    this->containers = 0;
+    this->capacity = 0;
+    this->arena_size = 0;
+    *error = cjson_prescan_run(this, data, size, max_depth, max_values);
+    if(*error != cjson_no_parse_error) {
+        cjson_dealloc(NULL, this->counts);
+        cjson_dealloc(NULL, this);
         return NULL;
     }
-    Token* token = tokenizer_make_simple_token(this, (TokenType)token_type, this->cursor + 1);
-    ++this->cursor;
-    return token;
+    return this;
 }
 
-void tokenizer_skip_blank(TokenizerContext* this) {
-    while(BLANK_TOKEN_MAP[(int)(*this->cursor)] == 1) {
-        ++this->cursor;
-    }
+void cjson_prescan_free(CJsonPrescan* this) {
+    cjson_dealloc(NULL, this->counts);
+    cjson_dealloc(NULL, this);
 }
 
-Token* tokenizer_consume_next(TokenizerContext* this) {
-    tokenizer_skip_blank(this);
-    char hint = *this->cursor;
-
-    if(PUNCTUATION_TOKEN_MAP[(int)hint] != 0) {
-        return tokenizer_try_tokenize_punctuation(this);
-    }
-
-    if(hint == '"') {
-        return tokenizer_try_tokenize_string(this);
-    }
-
-    if(isdigit(hint) || hint == '-') {
-        return tokenizer_try_tokenize_number(this);
-    }
-
-    if(hint == 't') {
-        return tokenizer_try_tokenize_true(this);
+CJsonValue* cjson_read_impl(char* data, size_t size, const CJsonReadOptions* options, CJsonPrescan* prescan, CJsonAllocator* allocator, CJsonParseError* error) {
+    const CJsonParserLimits limits = {
+        .max_size = options->max_size,
+        .max_string_length = options->max_string_length,
+        .max_values = options->max_values,
+        .max_memory = options->max_memory
+    };
+    CJsonParser* parser = cjson_parser_acquire();
+    cjson_parser_reset(parser, allocator);
+    cjson_parser_set_max_depth(parser, options->max_depth);
+    cjson_parser_set_limits(parser, &limits);
+    cjson_parser_set_lazy(parser, options->lazy);
+    if(prescan != NULL) {
+        cjson_impl_parser_presize(parser, prescan->counts, prescan->containers);
     }
+    CJsonValue* value = options->in_situ
+        ? cjson_impl_parser_read_in_situ(parser, data, size)
+        : cjson_parser_read(parser, data, size);
+    *error = cjson_parser_error(parser);
+    cjson_parser_release(parser);
+    return value;
+}
 
-    if(hint == 'f') {
-        return tokenizer_try_tokenize_false(this);
+CJsonValue* cjson_read_bytes_with_error(char* data, size_t size, const CJsonReadOptions* options, CJsonAllocator* allocator, CJsonParseError* error) {
+    const CJsonReadOptions default_options = cjson_read_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonParseError ignored_error = cjson_no_parse_error;
+    if(error == NULL) { error = &ignored_error; }
+    *error = cjson_no_parse_error;
+    // Fails before the prescan, which would otherwise read the whole input.
+    if(options->max_size != 0 && size > options->max_size) {
+        *error = cjson_size_parse_error;
+        return NULL;
     }
-
-    if(hint == 'n') {
-        return tokenizer_try_tokenize_null(this);
+    if(!options->presize) {
+        return cjson_read_impl(data, size, options, NULL, allocator, error);
     }
-
-    return NULL;
+    CJsonPrescan* prescan = cjson_prescan_new(data, size, options->max_depth, options->max_values, error);
+    if(prescan == NULL) { return NULL; }
+    CJsonValue* value = cjson_read_impl(data, size, options, prescan, allocator, error);
+    cjson_prescan_free(prescan);
+    return value;
 }
 
-Token* tokenizer_get_next(TokenizerContext* this) {
-    TokenizerContext ctx_copy = {
-        .cursor = this->cursor,
-        .token = this->token,
-        .buffer = this->buffer
-    };
-    return tokenizer_consume_next(&ctx_copy);
+CJsonValue* cjson_read_bytes(char* data, size_t size, const CJsonReadOptions* options, CJsonAllocator* allocator) {
+    return cjson_read_bytes_with_error(data, size, options, allocator, NULL);
 }
 
-void tokenizer_consume_token(TokenizerContext* this, const Token* token) {
-    this->cursor = token->end;
+CJsonValue* cjson_read_with_options(char* data, const CJsonReadOptions* options, CJsonAllocator* allocator) {
+    return cjson_read_bytes(data, strlen(data), options, allocator);
 }
 
-CJsonValue* cjson_read_value(TokenizerContext* ctx, CJsonAllocator* allocator);
-
-CJsonObject* cjson_read_object(TokenizerContext* ctx, CJsonAllocator* allocator) {
-    CJsonObject* object = cjson_object_new(allocator);
-    bool has_trailing_comma = false;
+bool cjson_impl_file_input_read(CJsonFileInput* this, int fd) {
+    size_t capacity = CJSON_READER_FILE_CHUNK_SIZE;
+    this->data = (char*) cjson_alloc(NULL, capacity);
+    this->size = 0;
+    if(this->data == NULL) { return false; }
     for(;;) {
-        Token* token = tokenizer_consume_next(ctx);
-        if(token == NULL) {
-            return NULL;
-        }
-
-        if(token->type == cjson_right_brace_token) {
-            if(has_trailing_comma) {
-                return NULL;
-            }
-            return object;
-        }
-        if(token->type == cjson_comma_token) {
-            if(has_trailing_comma) {
-                return NULL;
+        if(this->size == capacity) {
+            char* data = (char*) cjson_realloc(NULL, this->data, capacity * 2);
+            if(data == NULL) {
+                cjson_dealloc(NULL, this->data);
+                return false;
             }
-            has_trailing_comma = true;
-            continue;
+            this->data = data;
+            capacity *= 2;
         }
-        if(token->type != cjson_str_token) {
-            return NULL;
+        const ssize_t read_size = read(fd, this->data + this->size, capacity - this->size);
+        if(read_size < 0 && errno == EINTR) { continue; }
+        if(read_size < 0) {
+            const int error = errno;
+            cjson_dealloc(NULL, this->data);
+            errno = error;
+            return false;
         }
-        char* key = cjson_raw_str_copy(token->data, allocator);
-        {
-            Token* colon_token = tokenizer_consume_next(ctx);
-            const TokenType colon_token_type = colon_token->type;
-            if(colon_token_type != cjson_colon_token) {
-                return NULL;
-            }
-        }
-        CJsonValue* val = cjson_read_value(ctx, allocator);
-        if(val == NULL) {
-            return NULL;
+        if(read_size == 0) {
+            this->is_mapped = false;
+            return true;
         }
-        cjson_object_set(object, key, val);
-        cjson_dealloc(allocator, key);
-        has_trailing_comma = false;
+        this->size += read_size;
     }
 }
 
-CJsonArray* cjson_read_array(TokenizerContext* ctx, CJsonAllocator* allocator) {
-    CJsonArray* array = cjson_array_new(allocator);
-    bool has_trailing_comma = false;
-    for(;;) {
-        Token* token = tokenizer_get_next(ctx);
-        if(token == NULL) {
-            return NULL;
+bool cjson_impl_file_input_open(CJsonFileInput* this, const char* path, bool writable) {
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0) { return false; }
+    struct stat file_stat;
+    bool opened = false;
+    this->is_mapped = fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0;
+    if(this->is_mapped) {
+        // Private mappings take writes, which in situ reads need, without reaching the file.
+        this->size = file_stat.st_size;
+        this->data = (char*) mmap(NULL, this->size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_PRIVATE, fd, 0);
+        opened = this->data != MAP_FAILED;
+        if(opened) {
+            // The whole file is read ahead while the parser works through the pages already in.
+            madvise(this->data, this->size, MADV_SEQUENTIAL);
+            madvise(this->data, this->size, MADV_WILLNEED);
         }
-
-        if(token->type == cjson_right_bracket_token) {
-            tokenizer_consume_token(ctx, token);
-            if(has_trailing_comma) {
-                return NULL;
-            }
-            return array;
-        }
-        if(token->type == cjson_comma_token) {
-            tokenizer_consume_token(ctx, token);
-            if(has_trailing_comma) {
-                return NULL;
-            }
-            has_trailing_comma = true;
-            continue;
-        }
-        CJsonValue* val = cjson_read_value(ctx, allocator);
-        if(val == NULL) {
-            return NULL;
-        }
-        cjson_array_push(array, val);
-        has_trailing_comma = false;
     }
+    else {
+        opened = cjson_impl_file_input_read(this, fd);
+    }
+    close(fd);
+    return opened;
 }
 
-CJsonValue* cjson_read_value(TokenizerContext* ctx, CJsonAllocator* allocator) {
-    Token* token = tokenizer_consume_next(ctx);
-    if(token == NULL) {
-        return NULL;
+void cjson_impl_file_input_close(CJsonFileInput* this) {
+    if(this->is_mapped) {
+        munmap(this->data, this->size);
     }
-
-    CJsonValue* value = NULL;
-    const TokenType token_type = token->type;
-    switch(token_type) {
-        case cjson_null_token: { value = cjson_value_new_as_null(allocator); break; }
-        case cjson_str_token: {
-            CJsonStr* str = cjson_str_new_from_raw(token->data, allocator);
-            value = cjson_value_new_as_str(str, allocator);
-            break;
-        }
-        case cjson_number_token: {
-            const double number_val = strtod(token->data, NULL);
-            value = cjson_value_new_as_number(number_val, allocator);
-            break;
-        }
-        case cjson_true_token: {
-            value = cjson_value_new_as_bool(true, allocator);
-            break;
-        }
-        case cjson_false_token: {
-            value = cjson_value_new_as_bool(false, allocator);
-            break;
-        }
-        case cjson_left_brace_token: {
-            CJsonObject* object = cjson_read_object(ctx, allocator);
-            if(object == NULL) { return NULL; }
-            value = cjson_value_new_as_object(object, allocator);
-            break;
-        }
-        case cjson_left_bracket_token: {
-            CJsonArray* array = cjson_read_array(ctx, allocator);
-            if(array == NULL) { return NULL; }
-            value = cjson_value_new_as_array(array, allocator);
-            break;
-        }
-        default:
-            break;
+    else {
+        cjson_dealloc(NULL, this->data);
     }
-    if(value == NULL) {
+}
 
-    }
+CJsonValue* cjson_read_file(const char* path, const CJsonReadOptions* options, CJsonAllocator* allocator) {
+    CJsonReadOptions file_options = options == NULL ? cjson_read_options_default() : *options;
+    // The input is released before returning: no value may borrow from it.
+    file_options.lazy = false;
+    file_options.in_situ = false;
+    CJsonFileInput input;
+    if(!cjson_impl_file_input_open(&input, path, false)) { return NULL; }
+    CJsonValue* value = cjson_read_bytes(input.data, input.size, &file_options, allocator);
+    cjson_impl_file_input_close(&input);
     return value;
 }
 
-CJsonValue* cjson_read_impl(char* data, CJsonAllocator* allocator) {
-    TokenizerContext* ctx = tokenizer_new(data, k_default_buffer_size, allocator);
-    CJsonValue* value = cjson_read_value(ctx, allocator);
-    tokenizer_free(ctx);
-    return value;
+CJsonReadOptions cjson_read_options_default() {
+    const CJsonReadOptions options = {
+        .max_depth = 0,
+        .presize = false,
+        .lazy = false,
+        .in_situ = false,
+        .max_size = 0,
+        .max_string_length = 0,
+        .max_values = 0,
+        .max_memory = 0
+    };
+    return options;
 }
 
 CJsonValue* cjson_read(char* data, CJsonAllocator* allocator) {
-    return cjson_read_impl(data, allocator);
+    return cjson_read_with_options(data, NULL, allocator);
+}
+
+CJsonValue* cjson_read_presized(char* data, CJsonAllocator* allocator) {
+    CJsonReadOptions options = cjson_read_options_default();
+    options.presize = true;
+    return cjson_read_with_options(data, &options, allocator);
+}
+
+size_t cjson_read_arena_size(const char* data) {
+    CJsonParseError error = cjson_no_parse_error;
+    CJsonPrescan* prescan = cjson_prescan_new(data, strlen(data), 0, 0, &error);
+    if(prescan == NULL) { return 0; }
+    const size_t arena_size = prescan->arena_size;
+    cjson_prescan_free(prescan);
+    return arena_size;
 }
@@ -0,0 +1,105 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_scanner.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CJSON_SCANNER_SSE2
+#endif
+
+
+const char STRUCTURAL_CHAR_MAP[] = {
+ /* 000 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 016 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 032 */  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,
+ /* 048 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,
+ /* 064 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 080 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  1,  0,  0,
+ /* 096 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 112 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  1,  0,  0,
+ /* 128 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 144 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 160 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 176 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 192 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 208 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 224 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 240 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+#ifdef CJSON_SCANNER_SSE2
+
+static inline int cjson_impl_string_special_mask(__m128i chunk) {
+    const __m128i quotes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    const __m128i backslashes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8(_mm_or_si128(quotes, backslashes));
+}
+
+// Control characters and non-ASCII bytes are the ones below 0x20 as signed bytes.
+static inline int cjson_impl_string_strict_mask(__m128i chunk) {
+    const __m128i below_space = _mm_cmplt_epi8(chunk, _mm_set1_epi8(0x20));
+    return cjson_impl_string_special_mask(chunk) | _mm_movemask_epi8(below_space);
+}
+
+static inline int cjson_impl_structural_mask(__m128i chunk) {
+    __m128i mask = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}')));
+    return _mm_movemask_epi8(mask);
+}
+
+#endif
+
+const char* cjson_scan_string_end(const char* cursor, const char* end) {
+    for(;;) {
+#ifdef CJSON_SCANNER_SSE2
+        while(end - cursor >= 16) {
+            const int mask = cjson_impl_string_special_mask(_mm_loadu_si128((const __m128i*) cursor));
+            if(mask != 0) {
+                cursor += __builtin_ctz(mask);
+                break;
+            }
+            cursor += 16;
+        }
+#endif
+        while(cursor != end && *cursor != '"' && *cursor != '\\') { ++cursor; }
+        if(cursor == end) { return NULL; }
+        if(*cursor == '"') { return cursor; }
+        // Escape sequence: the escaped character can never close the string.
+        cursor += 2;
+        if(cursor >= end) { return NULL; }
+    }
+}
+
+const char* cjson_scan_string_special(const char* cursor, const char* end) {
+#ifdef CJSON_SCANNER_SSE2
+    while(end - cursor >= 16) {
+        const int mask = cjson_impl_string_strict_mask(_mm_loadu_si128((const __m128i*) cursor));
+        if(mask != 0) { return cursor + __builtin_ctz(mask); }
+        cursor += 16;
+    }
+#endif
+    for(; cursor != end; ++cursor) {
+        const unsigned char c = (unsigned char) *cursor;
+        if(c == '"' || c == '\\' || c < 0x20 || c >= 0x80) { break; }
+    }
+    return cursor;
+}
+
+const char* cjson_scan_structural(const char* cursor, const char* end) {
+#ifdef CJSON_SCANNER_SSE2
+    while(end - cursor >= 16) {
+        const int mask = cjson_impl_structural_mask(_mm_loadu_si128((const __m128i*) cursor));
+        if(mask != 0) { return cursor + __builtin_ctz(mask); }
+        cursor += 16;
+    }
+#endif
+    while(cursor != end && !STRUCTURAL_CHAR_MAP[(unsigned char) *cursor]) { ++cursor; }
+    return cursor;
+}
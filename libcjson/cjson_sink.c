@@ -0,0 +1,124 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_allocator.h"
+#include "cjson_sink.h"
+#include "cjson_stringstream.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#ifndef CJSON_SINK_BUFFER_SIZE
+#define CJSON_SINK_BUFFER_SIZE ((size_t) 1 << 16)
+#endif
+
+
+void cjson_sink_init(CJsonSink* this, CJsonSinkWrite write, void* context, char* buffer, size_t capacity) {
+    this->_write = write;
+    this->_context = context;
+    this->_buffer = buffer;
+    this->_size = 0;
+    this->_capacity = buffer != NULL ? capacity : 0;
+    this->_failed = false;
+    this->_overflow = 0;
+    this->_allocator = NULL;
+}
+
+void cjson_buffer_sink_init(CJsonSink* this, char* buffer, size_t capacity) {
+    cjson_sink_init(this, NULL, NULL, buffer, capacity);
+}
+
+size_t cjson_buffer_sink_size(const CJsonSink* this) {
+    return this->_size + this->_overflow;
+}
+
+void cjson_string_stream_sink_init(CJsonSink* this, CJsonStringStream* stream) {
+    cjson_sink_init(this, cjson_string_stream_sink_write, stream, NULL, 0);
+}
+
+CJsonSink* cjson_sink_new(CJsonSinkWrite write, void* context, CJsonAllocator* allocator) {
+    allocator = cjson_allocator_or_default(allocator);
+    CJsonSink* this = (CJsonSink*) cjson_alloc_kind(allocator, sizeof(CJsonSink), cjson_buffer_allocation);
+    if(this == NULL) { return NULL; }
+    char* buffer = (char*) cjson_alloc_kind(allocator, CJSON_SINK_BUFFER_SIZE, cjson_buffer_allocation);
+    if(buffer == NULL) {
+        cjson_dealloc(allocator, this);
+        return NULL;
+    }
+    cjson_sink_init(this, write, context, buffer, CJSON_SINK_BUFFER_SIZE);
+    this->_allocator = allocator;
+    return this;
+}
+
+CJsonSink* cjson_fd_sink_new(int fd, CJsonAllocator* allocator) {
+    return cjson_sink_new(cjson_fd_sink_write, (void*) (intptr_t) fd, allocator);
+}
+
+CJsonSink* cjson_file_sink_new(FILE* file, CJsonAllocator* allocator) {
+    return cjson_sink_new(cjson_file_sink_write, file, allocator);
+}
+
+void cjson_sink_free(CJsonSink* this) {
+    if(this->_allocator == NULL) { return; }
+    cjson_dealloc(this->_allocator, this->_buffer);
+    cjson_dealloc(this->_allocator, this);
+}
+
+void cjson_impl_sink_hand_over(CJsonSink* this, const char* data, size_t size) {
+    if(this->_failed || size == 0) { return; }
+    this->_failed = !this->_write(this->_context, data, size);
+}
+
+bool cjson_sink_flush(CJsonSink* this) {
+    if(this->_write == NULL) { return !this->_failed; }
+    cjson_impl_sink_hand_over(this, this->_buffer, this->_size);
+    this->_size = 0;
+    return !this->_failed;
+}
+
+bool cjson_sink_failed(const CJsonSink* this) {
+    return this->_failed;
+}
+
+void cjson_impl_sink_write_slow(CJsonSink* this, const char* data, size_t size) {
+    if(this->_write == NULL) {
+        const size_t fitting = this->_capacity - this->_size;
+        if(fitting > 0) {
+            memcpy(this->_buffer + this->_size, data, fitting);
+        }
+        this->_size = this->_capacity;
+        this->_overflow += size - fitting;
+        this->_failed = true;
+        return;
+    }
+    cjson_sink_flush(this);
+    if(size >= this->_capacity) {
+        cjson_impl_sink_hand_over(this, data, size);
+        return;
+    }
+    memcpy(this->_buffer, data, size);
+    this->_size = size;
+}
+
+bool cjson_fd_sink_write(void* context, const char* data, size_t size) {
+    const int fd = (int) (intptr_t) context;
+    while(size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if(written < 0 && errno == EINTR) { continue; }
+        if(written <= 0) { return false; }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool cjson_file_sink_write(void* context, const char* data, size_t size) {
+    return fwrite(data, 1, size, (FILE*) context) == size;
+}
+
+bool cjson_string_stream_sink_write(void* context, const char* data, size_t size) {
+    cjson_string_stream_write_bytes((CJsonStringStream*) context, data, size);
+    return true;
+}
@@ -8,6 +8,7 @@
 
 #include "cjson_allocator.h"
 #include "cjson_assert.h"
+#include "cjson_sink.h"
 #include "cjson_str.h"
 
 #include <string.h>
@@ -15,12 +16,12 @@
 
 CJsonStr* cjson_str_new_of_size(size_t size, char c, CJsonAllocator* allocator) {
     allocator = cjson_allocator_or_default(allocator);
-    CJsonStr* str = (CJsonStr*) cjson_alloc(allocator, sizeof(CJsonStr));
+    CJsonStr* str = (CJsonStr*) cjson_alloc_kind(allocator, sizeof(CJsonStr), cjson_str_allocation);
     if(str == NULL) {
         return NULL;
     }
     const size_t buffer_sz = sizeof(char) * (size + 1);
-    str->_data = (char*) cjson_alloc(allocator, buffer_sz);
+    str->_data = (char*) cjson_alloc_kind(allocator, buffer_sz, cjson_str_allocation);
     if(str->_data == NULL) {
         cjson_dealloc(allocator, str);
         return NULL;
@@ -29,9 +30,37 @@ CJsonStr* cjson_str_new_of_size(size_t size, char c, CJsonAllocator* allocator)
     str->_data[size] = '\0';
     str->_size = size;
     str->_allocator = allocator;
+    str->_is_view = false;
     return str;
 }
 
+CJsonStr* cjson_str_new_view(char* data, size_t size, CJsonAllocator* allocator) {
+    allocator = cjson_allocator_or_default(allocator);
+    CJsonStr* str = (CJsonStr*) cjson_alloc_kind(allocator, sizeof(CJsonStr), cjson_str_allocation);
+    if(str == NULL) {
+        return NULL;
+    }
+    str->_data = data;
+    str->_size = size;
+    str->_allocator = allocator;
+    str->_is_view = true;
+    return str;
+}
+
+// Gives a view its own copy of the bytes it borrows, before they get modified. Returns false,
+// leaving the view untouched, when the copy cannot be allocated.
+bool cjson_impl_str_own(CJsonStr* this) {
+    if(!this->_is_view) { return true; }
+    char* data = (char*) cjson_alloc_kind(this->_allocator, sizeof(char) * (this->_size + 1), cjson_str_allocation);
+    if(data == NULL) {
+        return false;
+    }
+    memcpy(data, this->_data, this->_size + 1);
+    this->_data = data;
+    this->_is_view = false;
+    return true;
+}
+
 CJsonStr* cjson_str_new(CJsonAllocator* allocator) {
     return cjson_str_new_of_size(0, '\0', allocator);
 }
@@ -43,28 +72,36 @@ CJsonStr* cjson_str_new_from_raw(const char* const cstr, CJsonAllocator* allocat
     return str;
 }
 
-CJsonStr* cjson_str_copy(const CJsonStr* const this) {
-    CJsonStr* str = cjson_str_new_of_size(this->_size, '\0', this->_allocator);
-    strcpy(str->_data, this->_data);
-    str->_size = this->_size;
+CJsonStr* cjson_str_new_from_bytes(const char* data, size_t size, CJsonAllocator* allocator) {
+    CJsonStr* str = cjson_str_new_of_size(size, '\0', allocator);
+    if(str == NULL) {
+        return NULL;
+    }
+    memcpy(str->_data, data, size * sizeof(char));
     return str;
 }
 
+CJsonStr* cjson_str_copy(const CJsonStr* const this) {
+    return cjson_str_new_from_bytes(this->_data, this->_size, this->_allocator);
+}
+
 char* cjson_raw_str_copy(const char* this, CJsonAllocator* allocator) {
     allocator = cjson_allocator_or_default(allocator);
-    char* buffer = (char*) cjson_alloc(allocator, (strlen(this) + 1) * sizeof(char));
+    char* buffer = (char*) cjson_alloc_kind(allocator, (strlen(this) + 1) * sizeof(char), cjson_key_allocation);
     strcpy(buffer, this);
     return buffer;
 }
 
 void cjson_str_free(CJsonStr* this) {
-    cjson_dealloc(this->_allocator, this->_data);
+    if(!this->_is_view) {
+        cjson_dealloc(this->_allocator, this->_data);
+    }
     cjson_dealloc(this->_allocator, this);
 }
 
 void cjson_str_append_raw_string(CJsonStr* this, const char* const source) {
     const size_t source_sz = strlen(source);
-    if(source_sz == 0) { return; }
+    if(source_sz == 0 || !cjson_impl_str_own(this)) { return; }
     this->_data = cjson_realloc(this->_allocator, this->_data, sizeof(char) * (this->_size + source_sz + 1));
     if(this->_data == NULL) {
         return;
@@ -78,6 +115,9 @@ void cjson_str_append(CJsonStr* this, const CJsonStr* source) {
 }
 
 void cjson_str_clear(CJsonStr* this) {
+    if(!cjson_impl_str_own(this)) {
+        return;
+    }
     this->_data = cjson_realloc(this->_allocator, this->_data, sizeof(char));
     this->_data[0] = '\0';
     this->_size = 0;
@@ -85,6 +125,9 @@ void cjson_str_clear(CJsonStr* this) {
 
 void cjson_str_pop_back(CJsonStr* this) {
     CJSON_ASSERT(this->_size > 0);
+    if(!cjson_impl_str_own(this)) {
+        return;
+    }
     --this->_size;
     this->_data[this->_size] = '\0';
 }
@@ -131,23 +174,49 @@ size_t cjson_str_length(const CJsonStr* const this) {
     return this->_size;
 }
 
+// Escape sequence of every byte that cannot appear as is within a JSON string, NULL for the others.
+const char* const STR_ESCAPE_MAP[256] = {
+    "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+    "\\b", "\\t", "\\n", "\\u000b", "\\f", "\\r", "\\u000e", "\\u000f",
+    "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+    "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f",
+    ['"'] = "\\\"",
+    ['\\'] = "\\\\"
+};
+
+void cjson_impl_str_write_bytes(CJsonSink* sink, const char* data, size_t size) {
+    const char* const end = data + size;
+    const char* run = data;
+    cjson_sink_put(sink, '"');
+    for(const char* ptr = data; ptr != end; ++ptr) {
+        const char* escape = STR_ESCAPE_MAP[(unsigned char) *ptr];
+        if(escape == NULL) { continue; }
+        cjson_sink_write(sink, run, ptr - run);
+        cjson_sink_write(sink, escape, strlen(escape));
+        run = ptr + 1;
+    }
+    cjson_sink_write(sink, run, end - run);
+    cjson_sink_put(sink, '"');
+}
+
+void cjson_str_write(CJsonSink* sink, const CJsonStr* const this) {
+    cjson_impl_str_write_bytes(sink, this->_data, this->_size);
+}
+
+void cjson_raw_str_write(CJsonSink* sink, const char* const str) {
+    cjson_impl_str_write_bytes(sink, str, strlen(str));
+}
+
 void cjson_str_fmt(CJsonStringStream* stream, const CJsonStr* const this) {
-    cjson_raw_str_fmt(stream, this->_data);
+    CJsonSink sink;
+    cjson_string_stream_sink_init(&sink, stream);
+    cjson_str_write(&sink, this);
 }
 
 void cjson_raw_str_fmt(CJsonStringStream* stream, const char* const str) {
-    const char* ptr = str;
-    cjson_string_stream_write(stream, "\"");
-    while(*ptr != '\0') {
-        if(*ptr == '\"') {
-            cjson_string_stream_write(stream, "\\\"");
-        }
-        else {
-            cjson_string_stream_write_bytes(stream, ptr, 1);
-        }
-        ++ptr;
-    }
-    cjson_string_stream_write(stream, "\"");
+    CJsonSink sink;
+    cjson_string_stream_sink_init(&sink, stream);
+    cjson_raw_str_write(&sink, str);
 }
 
 char* cjson_str_raw(const CJsonStr* const this) {
@@ -0,0 +1,489 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_stream_reader.h"
+#include "cjson_allocator.h"
+#include "cjson_buffer.h"
+#include "cjson_parser.h"
+#include "cjson_scanner.h"
+#include "cjson_tokenizer.h"
+#include "cjson_utils.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#ifndef CJSON_STREAM_INITIAL_CARRY_SIZE
+#define CJSON_STREAM_INITIAL_CARRY_SIZE 4096
+#endif
+
+#define CJSON_STREAM_RECORD_SEPARATOR '\x1e'
+
+
+// Progress of the search for the end of a concatenated document, kept across feeds so that the
+// bytes of a document spanning many chunks are scanned once.
+typedef struct CJsonStreamScan {
+    // Bytes of the document scanned so far, 0 before it starts.
+    size_t offset;
+    // Open containers.
+    size_t depth;
+    bool in_string;
+    // In a string, the byte scanned last escapes the next one.
+    bool escaped;
+    bool in_scalar;
+} CJsonStreamScan;
+
+typedef struct CJsonStreamWorker {
+    CJsonImplStreamReader* reader;
+    pthread_t thread;
+    CJsonAllocator* arena;
+    CJsonParser* parser;
+    // Last batch started by this worker.
+    size_t generation;
+    // Records [first, last) of the batch are parsed by this worker.
+    size_t first;
+    size_t last;
+} CJsonStreamWorker;
+
+typedef struct CJsonImplStreamReader {
+    CJsonStreamReaderOptions options;
+    CJsonStreamHandler handler;
+    void* context;
+    // Start of a record whose end was not part of the chunks fed so far.
+    CJsonBuffer* carry;
+    size_t carry_size;
+    // Concatenated framing: scan of the carried record.
+    CJsonStreamScan scan;
+    // Records completed by the current feed.
+    CJsonStreamRecord* records;
+    size_t record_count;
+    size_t record_capacity;
+    size_t next_index;
+    CJsonStreamWorker* workers;
+    size_t worker_count;
+    // Workers running on a thread of their own, 0 when the feeding thread parses the batches.
+    size_t thread_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    pthread_cond_t turn_cond;
+    size_t generation;
+    size_t busy;
+    // Ordered mode: worker whose records are handed over next.
+    size_t turn;
+    bool exiting;
+    atomic_bool stopped;
+} CJsonImplStreamReader;
+
+void cjson_impl_stream_reader_hand_over(CJsonImplStreamReader* this, const CJsonStreamRecord* record) {
+    if(atomic_load(&this->stopped)) { return; }
+    if(!this->handler(this->context, record)) {
+        atomic_store(&this->stopped, true);
+    }
+}
+
+void cjson_impl_stream_worker_run(CJsonStreamWorker* this) {
+    CJsonImplStreamReader* reader = this->reader;
+    const bool ordered = reader->options.ordered;
+    cjson_linear_allocator_reset(this->arena);
+    for(size_t i = this->first; i < this->last && !atomic_load(&reader->stopped); ++i) {
+        CJsonStreamRecord* record = &reader->records[i];
+        cjson_parser_reset(this->parser, this->arena);
+        record->value = cjson_parser_read(this->parser, record->data, record->size);
+        if(!ordered) {
+            cjson_impl_stream_reader_hand_over(reader, record);
+            cjson_linear_allocator_reset(this->arena);
+        }
+    }
+    if(!ordered) { return; }
+    // Workers hold contiguous slices of the batch: they hand them over one after the other.
+    const size_t worker_index = this - reader->workers;
+    pthread_mutex_lock(&reader->mutex);
+    while(reader->turn != worker_index) {
+        pthread_cond_wait(&reader->turn_cond, &reader->mutex);
+    }
+    pthread_mutex_unlock(&reader->mutex);
+    for(size_t i = this->first; i < this->last; ++i) {
+        cjson_impl_stream_reader_hand_over(reader, &reader->records[i]);
+    }
+    pthread_mutex_lock(&reader->mutex);
+    ++reader->turn;
+    pthread_cond_broadcast(&reader->turn_cond);
+    pthread_mutex_unlock(&reader->mutex);
+}
+
+void* cjson_impl_stream_worker_main(void* argument) {
+    CJsonStreamWorker* this = (CJsonStreamWorker*) argument;
+    CJsonImplStreamReader* reader = this->reader;
+    for(;;) {
+        pthread_mutex_lock(&reader->mutex);
+        while(this->generation == reader->generation && !reader->exiting) {
+            pthread_cond_wait(&reader->work_cond, &reader->mutex);
+        }
+        if(reader->exiting) {
+            pthread_mutex_unlock(&reader->mutex);
+            return NULL;
+        }
+        this->generation = reader->generation;
+        pthread_mutex_unlock(&reader->mutex);
+
+        cjson_impl_stream_worker_run(this);
+
+        pthread_mutex_lock(&reader->mutex);
+        if(--reader->busy == 0) {
+            pthread_cond_signal(&reader->done_cond);
+        }
+        pthread_mutex_unlock(&reader->mutex);
+    }
+}
+
+// Splits the batch into contiguous slices of about the same number of bytes.
+void cjson_impl_stream_reader_assign_slices(CJsonImplStreamReader* this) {
+    size_t total_size = 0;
+    for(size_t i = 0; i < this->record_count; ++i) {
+        total_size += this->records[i].size;
+    }
+    size_t record = 0;
+    size_t assigned_size = 0;
+    for(size_t w = 0; w < this->worker_count; ++w) {
+        CJsonStreamWorker* worker = &this->workers[w];
+        const bool is_last = w + 1 == this->worker_count;
+        const size_t target_size = total_size / this->worker_count * (w + 1);
+        worker->first = record;
+        while(record < this->record_count && (is_last || assigned_size < target_size)) {
+            assigned_size += this->records[record++].size;
+        }
+        worker->last = record;
+    }
+}
+
+void cjson_impl_stream_reader_dispatch(CJsonImplStreamReader* this) {
+    if(this->record_count == 0) { return; }
+    cjson_impl_stream_reader_assign_slices(this);
+    this->turn = 0;
+    if(this->thread_count == 0) {
+        cjson_impl_stream_worker_run(&this->workers[0]);
+        this->record_count = 0;
+        return;
+    }
+    pthread_mutex_lock(&this->mutex);
+    this->busy = this->worker_count;
+    ++this->generation;
+    pthread_cond_broadcast(&this->work_cond);
+    while(this->busy > 0) {
+        pthread_cond_wait(&this->done_cond, &this->mutex);
+    }
+    pthread_mutex_unlock(&this->mutex);
+    this->record_count = 0;
+}
+
+// Adds a record to the batch, unless it is blank. JSON text sequences start with a separator.
+void cjson_impl_stream_reader_push(CJsonImplStreamReader* this, const char* data, size_t size) {
+    if(this->options.framing == cjson_json_seq_framing && size > 0 && *data == CJSON_STREAM_RECORD_SEPARATOR) {
+        ++data;
+        --size;
+    }
+    if(cjson_tokenizer_skip_blank(data, data + size) == data + size) { return; }
+    if(this->record_count == this->record_capacity) {
+        // Out of memory, the stream stops as if the handler had asked to.
+        const size_t capacity = CJSON_MAX(this->record_capacity * 2, 64);
+        CJsonStreamRecord* records = (CJsonStreamRecord*) cjson_realloc(NULL, this->records, capacity * sizeof(CJsonStreamRecord));
+        if(records == NULL) {
+            atomic_store(&this->stopped, true);
+            return;
+        }
+        this->records = records;
+        this->record_capacity = capacity;
+    }
+    CJsonStreamRecord* record = &this->records[this->record_count++];
+    record->index = this->next_index++;
+    record->data = data;
+    record->size = size;
+    record->value = NULL;
+}
+
+// Scans the document starting at `start` from where `this` left it, and returns its end. When it
+// may go on past `end`, returns NULL and records how far it got.
+const char* cjson_impl_stream_scan(CJsonStreamScan* this, const char* start, const char* end) {
+    const char* cursor = start + this->offset;
+    if(cursor == end) { return NULL; }
+    if(this->offset == 0) {
+        switch(cjson_char_class(*cursor)) {
+            case cjson_quote_char: this->in_string = true; ++cursor; break;
+            case cjson_left_brace_char:
+            case cjson_left_bracket_char: break;
+            case cjson_digit_char:
+            case cjson_minus_char:
+            case cjson_scalar_char: this->in_scalar = true; break;
+            // A byte which starts no document makes a malformed record of its own.
+            default: return cursor + 1;
+        }
+    }
+    if(this->in_scalar) {
+        const char* scalar_end = cjson_tokenizer_scalar_end(cursor, end);
+        if(scalar_end != end) { return scalar_end; }
+        this->offset = end - start;
+        return NULL;
+    }
+    for(;;) {
+        if(this->in_string) {
+            const char* content = cursor;
+            if(this->escaped && content != end) {
+                ++content;
+                this->escaped = false;
+            }
+            const char* closing_quote = cjson_scan_string_end(content, end);
+            if(closing_quote == NULL) {
+                this->escaped = cjson_tokenizer_ends_with_escape(content, end);
+                this->offset = end - start;
+                return NULL;
+            }
+            this->in_string = false;
+            cursor = closing_quote + 1;
+            if(this->depth == 0) { return cursor; }
+        }
+        cursor = cjson_scan_structural(cursor, end);
+        if(cursor == end) {
+            this->offset = end - start;
+            return NULL;
+        }
+        switch(*cursor) {
+            case '"': this->in_string = true; break;
+            case '{':
+            case '[': ++this->depth; break;
+            case '}':
+            case ']': {
+                if(--this->depth == 0) { return cursor + 1; }
+                break;
+            }
+            default: break;
+        }
+        ++cursor;
+    }
+}
+
+// Adds the records completed within [cursor, end) to the batch and returns the start of the
+// incomplete record which follows them.
+const char* cjson_impl_stream_reader_split(CJsonImplStreamReader* this, const char* cursor, const char* end) {
+    switch(this->options.framing) {
+        case cjson_ndjson_framing: {
+            for(;;) {
+                const char* newline = (const char*) memchr(cursor, '\n', end - cursor);
+                if(newline == NULL) { return cursor; }
+                cjson_impl_stream_reader_push(this, cursor, newline - cursor);
+                cursor = newline + 1;
+            }
+        }
+        case cjson_json_seq_framing: {
+            // A record runs up to the separator of the next one.
+            while(end - cursor > 1) {
+                const char* separator = (const char*) memchr(cursor + 1, CJSON_STREAM_RECORD_SEPARATOR, end - cursor - 1);
+                if(separator == NULL) { break; }
+                cjson_impl_stream_reader_push(this, cursor, separator - cursor);
+                cursor = separator;
+            }
+            return cursor;
+        }
+        case cjson_concatenated_framing: {
+            for(;;) {
+                cursor = cjson_tokenizer_skip_blank(cursor, end);
+                if(cursor == end) { return cursor; }
+                memset(&this->scan, 0, sizeof(CJsonStreamScan));
+                const char* document_end = cjson_impl_stream_scan(&this->scan, cursor, end);
+                if(document_end == NULL) { return cursor; }
+                cjson_impl_stream_reader_push(this, cursor, document_end - cursor);
+                cursor = document_end;
+            }
+        }
+    }
+    return cursor;
+}
+
+void cjson_impl_stream_reader_carry(CJsonImplStreamReader* this, const char* data, size_t size) {
+    const size_t required_size = this->carry_size + size;
+    if(required_size > this->carry->size) {
+        cjson_buffer_resize(this->carry, CJSON_MAX(this->carry->size * 2, required_size));
+    }
+    memmove(this->carry->buffer + this->carry_size, data, size);
+    this->carry_size += size;
+}
+
+bool cjson_impl_stream_reader_feed(CJsonImplStreamReader* this, const char* chunk, size_t size) {
+    if(atomic_load(&this->stopped)) { return false; }
+    const char* cursor = chunk;
+    const char* const end = chunk + size;
+    if(this->carry_size > 0 && this->options.framing == cjson_concatenated_framing) {
+        // Documents have no delimiter to look for: the scan of the record carried over resumes
+        // on the chunk, whose remainder is then split.
+        cjson_impl_stream_reader_carry(this, chunk, size);
+        const char* carry_end = this->carry->buffer + this->carry_size;
+        const char* document_end = cjson_impl_stream_scan(&this->scan, this->carry->buffer, carry_end);
+        if(document_end == NULL) { return true; }
+        cjson_impl_stream_reader_push(this, this->carry->buffer, document_end - this->carry->buffer);
+        const char* rest = cjson_impl_stream_reader_split(this, document_end, carry_end);
+        cjson_impl_stream_reader_dispatch(this);
+        this->carry_size = 0;
+        cjson_impl_stream_reader_carry(this, rest, carry_end - rest);
+        return !atomic_load(&this->stopped);
+    }
+    if(this->carry_size > 0) {
+        const char delimiter = this->options.framing == cjson_ndjson_framing ? '\n' : CJSON_STREAM_RECORD_SEPARATOR;
+        const char* record_end = (const char*) memchr(chunk, delimiter, size);
+        if(record_end == NULL) {
+            cjson_impl_stream_reader_carry(this, chunk, size);
+            return true;
+        }
+        cjson_impl_stream_reader_carry(this, chunk, record_end - chunk);
+        cjson_impl_stream_reader_push(this, this->carry->buffer, this->carry_size);
+        cursor = delimiter == '\n' ? record_end + 1 : record_end;
+    }
+    const char* rest = cjson_impl_stream_reader_split(this, cursor, end);
+    cjson_impl_stream_reader_dispatch(this);
+    this->carry_size = 0;
+    cjson_impl_stream_reader_carry(this, rest, end - rest);
+    return !atomic_load(&this->stopped);
+}
+
+bool cjson_impl_stream_reader_finish(CJsonImplStreamReader* this) {
+    if(this->carry_size > 0 && !atomic_load(&this->stopped)) {
+        cjson_impl_stream_reader_push(this, this->carry->buffer, this->carry_size);
+        cjson_impl_stream_reader_dispatch(this);
+    }
+    this->carry_size = 0;
+    return !atomic_load(&this->stopped);
+}
+
+// Asks the workers running a thread to exit and waits for them.
+void cjson_impl_stream_reader_stop_threads(CJsonImplStreamReader* this) {
+    if(this->thread_count == 0) { return; }
+    pthread_mutex_lock(&this->mutex);
+    this->exiting = true;
+    pthread_cond_broadcast(&this->work_cond);
+    pthread_mutex_unlock(&this->mutex);
+    for(size_t w = 0; w < this->thread_count; ++w) {
+        pthread_join(this->workers[w].thread, NULL);
+    }
+    this->thread_count = 0;
+}
+
+// Frees the workers past the first `count`, none of which runs a thread.
+void cjson_impl_stream_reader_drop_workers(CJsonImplStreamReader* this, size_t count) {
+    for(size_t w = count; w < this->worker_count; ++w) {
+        cjson_parser_free(this->workers[w].parser);
+        cjson_linear_allocator_free(this->workers[w].arena);
+    }
+    this->worker_count = count;
+}
+
+void cjson_impl_stream_reader_free(CJsonImplStreamReader* this) {
+    cjson_impl_stream_reader_stop_threads(this);
+    cjson_impl_stream_reader_drop_workers(this, 0);
+    pthread_cond_destroy(&this->turn_cond);
+    pthread_cond_destroy(&this->done_cond);
+    pthread_cond_destroy(&this->work_cond);
+    pthread_mutex_destroy(&this->mutex);
+    cjson_dealloc(NULL, this->workers);
+    cjson_dealloc(NULL, this->records);
+    cjson_buffer_free(this->carry);
+    cjson_dealloc(NULL, this);
+}
+
+CJsonImplStreamReader* cjson_impl_stream_reader_new(const CJsonStreamReaderOptions* options, CJsonStreamHandler handler, void* context) {
+    CJsonImplStreamReader* this = (CJsonImplStreamReader*) cjson_alloc_kind(NULL, sizeof(CJsonImplStreamReader), cjson_reader_allocation);
+    if(this == NULL) { return NULL; }
+    this->options = *options;
+    this->handler = handler;
+    this->context = context;
+    this->carry = cjson_buffer_new(CJSON_STREAM_INITIAL_CARRY_SIZE, NULL);
+    this->carry_size = 0;
+    memset(&this->scan, 0, sizeof(CJsonStreamScan));
+    this->records = NULL;
+    this->record_count = 0;
+    this->record_capacity = 0;
+    this->next_index = 0;
+    this->generation = 0;
+    this->busy = 0;
+    this->turn = 0;
+    this->exiting = false;
+    atomic_init(&this->stopped, false);
+    pthread_mutex_init(&this->mutex, NULL);
+    pthread_cond_init(&this->work_cond, NULL);
+    pthread_cond_init(&this->done_cond, NULL);
+    pthread_cond_init(&this->turn_cond, NULL);
+
+    const size_t worker_count = cjson_thread_count(options->threads);
+    this->worker_count = 0;
+    this->thread_count = 0;
+    this->workers = (CJsonStreamWorker*) cjson_alloc(NULL, worker_count * sizeof(CJsonStreamWorker));
+    if(this->workers == NULL) {
+        cjson_impl_stream_reader_free(this);
+        return NULL;
+    }
+    for(; this->worker_count < worker_count; ++this->worker_count) {
+        CJsonStreamWorker* worker = &this->workers[this->worker_count];
+        worker->reader = this;
+        worker->arena = cjson_mapped_linear_allocator_new(CJSON_ARENA_RESERVE, 0, cjson_mapped_arena_no_flags);
+        if(worker->arena == NULL) {
+            cjson_impl_stream_reader_free(this);
+            return NULL;
+        }
+        worker->parser = cjson_parser_new(NULL);
+        cjson_parser_set_max_depth(worker->parser, options->max_depth);
+        worker->generation = 0;
+        worker->first = 0;
+        worker->last = 0;
+    }
+    if(this->worker_count > 1) {
+        while(this->thread_count < this->worker_count
+              && pthread_create(&this->workers[this->thread_count].thread, NULL, cjson_impl_stream_worker_main, &this->workers[this->thread_count]) == 0) {
+            ++this->thread_count;
+        }
+        // Only the workers whose thread started are kept. A single one is no better than parsing inline.
+        if(this->thread_count < 2) {
+            cjson_impl_stream_reader_stop_threads(this);
+        }
+        cjson_impl_stream_reader_drop_workers(this, CJSON_MAX(this->thread_count, 1));
+    }
+    return this;
+}
+
+CJsonStreamReaderOptions cjson_stream_reader_options_default() {
+    const CJsonStreamReaderOptions options = {
+        .framing = cjson_ndjson_framing,
+        .threads = 0,
+        .ordered = true,
+        .max_depth = 0
+    };
+    return options;
+}
+
+CJsonStreamReader* cjson_stream_reader_new(const CJsonStreamReaderOptions* options, CJsonStreamHandler handler, void* context) {
+    const CJsonStreamReaderOptions default_options = cjson_stream_reader_options_default();
+    if(options == NULL) { options = &default_options; }
+    CJsonStreamReader* this = (CJsonStreamReader*) cjson_alloc_kind(NULL, sizeof(CJsonStreamReader), cjson_reader_allocation);
+    if(this == NULL) { return NULL; }
+    this->_impl = cjson_impl_stream_reader_new(options, handler, context);
+    if(this->_impl == NULL) {
+        cjson_dealloc(NULL, this);
+        return NULL;
+    }
+    return this;
+}
+
+void cjson_stream_reader_free(CJsonStreamReader* this) {
+    cjson_impl_stream_reader_free(this->_impl);
+    cjson_dealloc(NULL, this);
+}
+
+bool cjson_stream_reader_feed(CJsonStreamReader* this, const char* chunk, size_t size) {
+    return cjson_impl_stream_reader_feed(this->_impl, chunk, size);
+}
+
+bool cjson_stream_reader_finish(CJsonStreamReader* this) {
+    return cjson_impl_stream_reader_finish(this->_impl);
+}
+
+size_t cjson_stream_reader_count(const CJsonStreamReader* this) {
+    return this->_impl->next_index;
+}
@@ -30,8 +30,8 @@ typedef struct StringStreamBlock {
 } StringStreamBlock;
 
 StringStreamBlock* string_stream_block_new(CJsonAllocator* allocator) {
-    StringStreamBlock* block = (StringStreamBlock*) cjson_alloc(allocator, sizeof(StringStreamBlock));
-    block->data = (char*) cjson_alloc(allocator, CJSON_STRING_STREAM_BLOCK_SIZE * sizeof(char));
+    StringStreamBlock* block = (StringStreamBlock*) cjson_alloc_kind(allocator, sizeof(StringStreamBlock), cjson_stream_block_allocation);
+    block->data = (char*) cjson_alloc_kind(allocator, CJSON_STRING_STREAM_BLOCK_SIZE * sizeof(char), cjson_stream_block_allocation);
     block->size = 0;
     block->next = NULL;
     block->allocator = allocator;
@@ -96,12 +96,13 @@ void cjson_impl_string_stream_write_bytes(CJsonImplStringStream* this, const cha
 
 void cjson_impl_string_stream_write_double(CJsonImplStringStream* this, const double* val) {
     CJsonBuffer* buffer = this->format_buffer;
-    const size_t total_bytes = snprintf(buffer->buffer, buffer->size, "%.8f", *val) + 1;
-    if(total_bytes > buffer->size) {
-        cjson_buffer_resize(buffer, total_bytes);
-        sprintf(buffer->buffer, "%f", *val);
+    const size_t length = snprintf(buffer->buffer, buffer->size, "%.8f", *val);
+    if(length + 1 > buffer->size) {
+        cjson_buffer_resize(buffer, length + 1);
+        snprintf(buffer->buffer, buffer->size, "%.8f", *val);
     }
-    cjson_impl_string_stream_write_bytes(this, buffer->buffer, total_bytes);
+    // The terminating NUL stays out of the stream.
+    cjson_impl_string_stream_write_bytes(this, buffer->buffer, length);
 }
 
 size_t cjson_impl_string_stream_size(const CJsonImplStringStream* const this) {
@@ -0,0 +1,254 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_allocator.h"
+#include "cjson_tokenizer.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+const unsigned char CJSON_CHAR_CLASS_MAP[256] = {
+ /* 000 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  0,  0,  1,  0,  0,
+ /* 016 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 032 */  1,  0,  5,  0,  0,  0,  0,  0,  0,  0,  0,  4, 10,  3,  4,  0,
+ /* 048 */  2,  2,  2,  2,  2,  2,  2,  2,  2,  2, 11,  0,  0,  0,  0,  0,
+ /* 064 */  0,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+ /* 080 */  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  8,  0,  9,  0,  0,
+ /* 096 */  0,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+ /* 112 */  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  6,  0,  7,  0,  0,
+ /* 128 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 144 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 160 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 176 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 192 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 208 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 224 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* 240 */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+bool cjson_tokenizer_is_blank(char c) {
+    return cjson_char_class(c) == cjson_blank_char;
+}
+
+bool cjson_tokenizer_is_digit(char c) {
+    return cjson_char_class(c) == cjson_digit_char;
+}
+
+bool cjson_tokenizer_is_scalar_char(char c) {
+    const CJsonCharClass char_class = cjson_char_class(c);
+    return char_class == cjson_digit_char || char_class == cjson_minus_char || char_class == cjson_scalar_char;
+}
+
+const char* cjson_tokenizer_skip_blank(const char* cursor, const char* end) {
+    while(cursor != end && cjson_tokenizer_is_blank(*cursor)) { ++cursor; }
+    return cursor;
+}
+
+const char* cjson_tokenizer_scalar_end(const char* cursor, const char* end) {
+    while(cursor != end && cjson_tokenizer_is_scalar_char(*cursor)) { ++cursor; }
+    return cursor;
+}
+
+const char* cjson_tokenizer_skip_digits(const char* cursor, const char* end) {
+    while(cursor != end && cjson_tokenizer_is_digit(*cursor)) { ++cursor; }
+    return cursor;
+}
+
+bool cjson_tokenizer_is_number(const char* data, size_t size) {
+    const char* ptr = data;
+    const char* const end = data + size;
+    if(ptr != end && *ptr == '-') { ++ptr; }
+    if(ptr == end || !cjson_tokenizer_is_digit(*ptr)) { return false; }
+    // No leading zeros.
+    ptr = *ptr == '0' ? ptr + 1 : cjson_tokenizer_skip_digits(ptr, end);
+    if(ptr != end && *ptr == '.') {
+        ++ptr;
+        if(ptr == end || !cjson_tokenizer_is_digit(*ptr)) { return false; }
+        ptr = cjson_tokenizer_skip_digits(ptr, end);
+    }
+    if(ptr != end && (*ptr == 'e' || *ptr == 'E')) {
+        ++ptr;
+        if(ptr != end && (*ptr == '-' || *ptr == '+')) { ++ptr; }
+        if(ptr == end || !cjson_tokenizer_is_digit(*ptr)) { return false; }
+        ptr = cjson_tokenizer_skip_digits(ptr, end);
+    }
+    return ptr == end;
+}
+
+bool cjson_tokenizer_literal_equals(const char* data, size_t size, const char* literal) {
+    return strlen(literal) == size && memcmp(data, literal, size) == 0;
+}
+
+CJsonScalarKind cjson_tokenizer_classify_scalar(const char* data, size_t size) {
+    switch(size > 0 ? *data : '\0') {
+        case 'n': return cjson_tokenizer_literal_equals(data, size, "null") ? cjson_null_scalar : cjson_invalid_scalar;
+        case 't': return cjson_tokenizer_literal_equals(data, size, "true") ? cjson_true_scalar : cjson_invalid_scalar;
+        case 'f': return cjson_tokenizer_literal_equals(data, size, "false") ? cjson_false_scalar : cjson_invalid_scalar;
+        default: return cjson_tokenizer_is_number(data, size) ? cjson_number_scalar : cjson_invalid_scalar;
+    }
+}
+
+double cjson_tokenizer_number_value(const char* data, size_t size) {
+    char buffer[CJSON_TOKENIZER_NUMBER_BUFFER_SIZE];
+    char* copy = size < CJSON_TOKENIZER_NUMBER_BUFFER_SIZE ? buffer : (char*) cjson_alloc(NULL, size + 1);
+    if(copy == NULL) { return NAN; }
+    memcpy(copy, data, size);
+    copy[size] = '\0';
+    const double value = strtod(copy, NULL);
+    if(copy != buffer) {
+        cjson_dealloc(NULL, copy);
+    }
+    return value;
+}
+
+bool cjson_tokenizer_ends_with_escape(const char* cursor, const char* end) {
+    bool escape = false;
+    for(; cursor != end; ++cursor) {
+        escape = !escape && *cursor == '\\';
+    }
+    return escape;
+}
+
+bool cjson_tokenizer_has_escape(const char* data, size_t size) {
+    return memchr(data, '\\', size) != NULL;
+}
+
+bool cjson_impl_tokenizer_hex4(const char* data, unsigned* value) {
+    *value = 0;
+    for(size_t i = 0; i < 4; ++i) {
+        const char c = data[i];
+        unsigned digit;
+        if(c >= '0' && c <= '9') { digit = c - '0'; }
+        else if(c >= 'a' && c <= 'f') { digit = c - 'a' + 10; }
+        else if(c >= 'A' && c <= 'F') { digit = c - 'A' + 10; }
+        else { return false; }
+        *value = (*value << 4) | digit;
+    }
+    return true;
+}
+
+size_t cjson_impl_tokenizer_write_utf8(char* out, unsigned code_point) {
+    if(code_point < 0x80) {
+        out[0] = (char) code_point;
+        return 1;
+    }
+    if(code_point < 0x800) {
+        out[0] = (char) (0xC0 | (code_point >> 6));
+        out[1] = (char) (0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if(code_point < 0x10000) {
+        out[0] = (char) (0xE0 | (code_point >> 12));
+        out[1] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = (char) (0xF0 | (code_point >> 18));
+    out[1] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+// Decodes the `\u` sequence at `data`, a surrogate pair taking two of them. Lone surrogates are
+// kept as they are, encoded like any other code point.
+size_t cjson_impl_tokenizer_unescape_unicode(const char* data, const char* end, unsigned* code_point) {
+    if(end - data < 6 || !cjson_impl_tokenizer_hex4(data + 2, code_point)) { return 0; }
+    unsigned low = 0;
+    if(*code_point >= 0xD800 && *code_point < 0xDC00 && end - data >= 12
+       && data[6] == '\\' && data[7] == 'u' && cjson_impl_tokenizer_hex4(data + 8, &low)
+       && low >= 0xDC00 && low < 0xE000) {
+        *code_point = 0x10000 + ((*code_point - 0xD800) << 10) + (low - 0xDC00);
+        return 12;
+    }
+    return 6;
+}
+
+bool cjson_tokenizer_unescape(const char* data, size_t size, char* out, size_t* out_size) {
+    const char* const end = data + size;
+    size_t length = 0;
+    while(data != end) {
+        const char* backslash = (const char*) memchr(data, '\\', end - data);
+        const size_t run = (backslash == NULL ? end : backslash) - data;
+        memmove(out + length, data, run);
+        length += run;
+        if(backslash == NULL) { break; }
+        if(end - backslash < 2) { return false; }
+        data = backslash + 2;
+        switch(backslash[1]) {
+            case '"': out[length++] = '"'; break;
+            case '\\': out[length++] = '\\'; break;
+            case '/': out[length++] = '/'; break;
+            case 'b': out[length++] = '\b'; break;
+            case 'f': out[length++] = '\f'; break;
+            case 'n': out[length++] = '\n'; break;
+            case 'r': out[length++] = '\r'; break;
+            case 't': out[length++] = '\t'; break;
+            case 'u': {
+                unsigned code_point = 0;
+                const size_t sequence_size = cjson_impl_tokenizer_unescape_unicode(backslash, end, &code_point);
+                if(sequence_size == 0) { return false; }
+                length += cjson_impl_tokenizer_write_utf8(out + length, code_point);
+                data = backslash + sequence_size;
+                break;
+            }
+            default: return false;
+        }
+    }
+    *out_size = length;
+    return true;
+}
+
+bool cjson_syntax_expects_value(CJsonSyntaxState state) {
+    return state == cjson_syntax_value_state || state == cjson_syntax_first_value_state;
+}
+
+bool cjson_syntax_expects_key(CJsonSyntaxState state) {
+    return state == cjson_syntax_key_state || state == cjson_syntax_first_key_state;
+}
+
+bool cjson_syntax_can_close(CJsonSyntaxState state, bool is_object) {
+    const CJsonSyntaxState empty_state = is_object ? cjson_syntax_first_key_state : cjson_syntax_first_value_state;
+    return state == cjson_syntax_separator_state || state == empty_state;
+}
+
+CJsonSyntaxState cjson_syntax_after_value(size_t depth) {
+    return depth == 0 ? cjson_syntax_done_state : cjson_syntax_separator_state;
+}
+
+CJsonSyntaxState cjson_syntax_after_open(bool is_object) {
+    return is_object ? cjson_syntax_first_key_state : cjson_syntax_first_value_state;
+}
+
+CJsonSyntaxState cjson_syntax_after_comma(bool in_object) {
+    return in_object ? cjson_syntax_key_state : cjson_syntax_value_state;
+}
+
+void cjson_syntax_stack_init(CJsonSyntaxStack* this) {
+    this->depth = 0;
+}
+
+bool cjson_syntax_stack_push(CJsonSyntaxStack* this, bool is_object, size_t max_depth) {
+    if(this->depth == max_depth) { return false; }
+    const uint64_t mask = (uint64_t) 1 << (this->depth % 64);
+    if(is_object) {
+        this->bits[this->depth / 64] |= mask;
+    }
+    else {
+        this->bits[this->depth / 64] &= ~mask;
+    }
+    ++this->depth;
+    return true;
+}
+
+void cjson_syntax_stack_pop(CJsonSyntaxStack* this) {
+    --this->depth;
+}
+
+bool cjson_syntax_stack_top_is_object(const CJsonSyntaxStack* this) {
+    const size_t index = this->depth - 1;
+    return this->depth > 0 && ((this->bits[index / 64] >> (index % 64)) & 1);
+}
@@ -8,6 +8,14 @@
 
 #include "cjson_utils.h"
 
+#include <unistd.h>
+
 int cjson_mod(int x, int n) {
     return x % n;
 }
+
+size_t cjson_thread_count(size_t threads) {
+    if(threads != 0) { return threads; }
+    const long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return online_cpus > 0 ? (size_t) online_cpus : 1;
+}
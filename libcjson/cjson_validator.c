@@ -0,0 +1,183 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cjson_assert.h"
+#include "cjson_validator.h"
+#include "cjson_scanner.h"
+#include "cjson_tokenizer.h"
+
+CJSON_STATIC_ASSERT(CJSON_VALIDATOR_MAX_DEPTH <= CJSON_SYNTAX_MAX_DEPTH);
+
+
+// End of the UTF-8 sequence whose lead byte, not ASCII, is at `cursor`. NULL when the sequence is
+// truncated, overlong, encodes a surrogate or goes beyond U+10FFFF.
+const char* cjson_impl_validator_utf8_end(const char* cursor, const char* end) {
+    const unsigned char* bytes = (const unsigned char*) cursor;
+    // Range of the second byte, narrower after the lead bytes which could start invalid sequences.
+    unsigned char min = 0x80;
+    unsigned char max = 0xBF;
+    size_t length;
+    if(bytes[0] >= 0xC2 && bytes[0] <= 0xDF) {
+        length = 2;
+    }
+    else if(bytes[0] >= 0xE0 && bytes[0] <= 0xEF) {
+        length = 3;
+        if(bytes[0] == 0xE0) { min = 0xA0; }
+        if(bytes[0] == 0xED) { max = 0x9F; }
+    }
+    else if(bytes[0] >= 0xF0 && bytes[0] <= 0xF4) {
+        length = 4;
+        if(bytes[0] == 0xF0) { min = 0x90; }
+        if(bytes[0] == 0xF4) { max = 0x8F; }
+    }
+    else {
+        return NULL;
+    }
+    if((size_t) (end - cursor) < length || bytes[1] < min || bytes[1] > max) { return NULL; }
+    for(size_t i = 2; i < length; ++i) {
+        if((bytes[i] & 0xC0) != 0x80) { return NULL; }
+    }
+    return cursor + length;
+}
+
+// Closing quote of the string whose content starts at `cursor`. On failure, returns NULL and
+// points `error` at the offending byte.
+const char* cjson_impl_validator_string_end(const char* cursor, const char* end, const char** error) {
+    for(;;) {
+        cursor = cjson_scan_string_special(cursor, end);
+        if(cursor == end) {
+            *error = end;
+            return NULL;
+        }
+        const unsigned char c = (unsigned char) *cursor;
+        if(c == '"') { return cursor; }
+        if(c < 0x20) {
+            *error = cursor;
+            return NULL;
+        }
+        if(c >= 0x80) {
+            const char* sequence_end = cjson_impl_validator_utf8_end(cursor, end);
+            if(sequence_end == NULL) {
+                *error = cursor;
+                return NULL;
+            }
+            cursor = sequence_end;
+            continue;
+        }
+        if(end - cursor < 2) {
+            *error = end;
+            return NULL;
+        }
+        switch(cursor[1]) {
+            case '"':
+            case '\\':
+            case '/':
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't': cursor += 2; break;
+            case 'u': {
+                unsigned code_point = 0;
+                if(end - cursor < 6) {
+                    *error = end;
+                    return NULL;
+                }
+                if(!cjson_impl_tokenizer_hex4(cursor + 2, &code_point)) {
+                    *error = cursor;
+                    return NULL;
+                }
+                cursor += 6;
+                break;
+            }
+            default: {
+                *error = cursor;
+                return NULL;
+            }
+        }
+    }
+}
+
+// Offending byte of `data`, `end` when it ends too early, NULL when `data` is valid.
+const char* cjson_impl_validate(const char* data, size_t size) {
+    const char* cursor = data;
+    const char* const end = data + size;
+    CJsonSyntaxStack stack;
+    cjson_syntax_stack_init(&stack);
+    CJsonSyntaxState state = cjson_syntax_value_state;
+    for(;;) {
+        cursor = cjson_tokenizer_skip_blank(cursor, end);
+        if(cursor == end) { break; }
+        const char c = *cursor;
+        switch(c) {
+            case '{':
+            case '[': {
+                const bool is_object = c == '{';
+                if(!cjson_syntax_expects_value(state) || !cjson_syntax_stack_push(&stack, is_object, CJSON_VALIDATOR_MAX_DEPTH)) { return cursor; }
+                state = cjson_syntax_after_open(is_object);
+                ++cursor;
+                break;
+            }
+            case '}':
+            case ']': {
+                const bool is_object = c == '}';
+                if(stack.depth == 0 || cjson_syntax_stack_top_is_object(&stack) != is_object
+                   || !cjson_syntax_can_close(state, is_object)) {
+                    return cursor;
+                }
+                cjson_syntax_stack_pop(&stack);
+                state = cjson_syntax_after_value(stack.depth);
+                ++cursor;
+                break;
+            }
+            case ',': {
+                if(state != cjson_syntax_separator_state) { return cursor; }
+                state = cjson_syntax_after_comma(cjson_syntax_stack_top_is_object(&stack));
+                ++cursor;
+                break;
+            }
+            case ':': {
+                if(state != cjson_syntax_colon_state) { return cursor; }
+                state = cjson_syntax_value_state;
+                ++cursor;
+                break;
+            }
+            case '"': {
+                if(cjson_syntax_expects_key(state)) {
+                    state = cjson_syntax_colon_state;
+                }
+                else if(cjson_syntax_expects_value(state)) {
+                    state = cjson_syntax_after_value(stack.depth);
+                }
+                else {
+                    return cursor;
+                }
+                const char* error = NULL;
+                const char* closing_quote = cjson_impl_validator_string_end(cursor + 1, end, &error);
+                if(closing_quote == NULL) { return error; }
+                cursor = closing_quote + 1;
+                break;
+            }
+            default: {
+                const char* scalar_end = cjson_tokenizer_scalar_end(cursor, end);
+                if(!cjson_syntax_expects_value(state)
+                   || cjson_tokenizer_classify_scalar(cursor, scalar_end - cursor) == cjson_invalid_scalar) {
+                    return cursor;
+                }
+                state = cjson_syntax_after_value(stack.depth);
+                cursor = scalar_end;
+                break;
+            }
+        }
+    }
+    return state == cjson_syntax_done_state ? NULL : end;
+}
+
+bool cjson_validate(const char* data, size_t size, size_t* error_offset) {
+    const char* error = cjson_impl_validate(data, size);
+    if(error != NULL && error_offset != NULL) {
+        *error_offset = error - data;
+    }
+    return error == NULL;
+}
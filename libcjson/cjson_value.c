@@ -11,24 +11,118 @@
 #include "cjson_object.h"
 #include "cjson_str.h"
 #include "cjson_stringstream.h"
+#include "cjson_tokenizer.h"
 #include "cjson_value.h"
+#include "cjson_writer.h"
 
 #include <string.h>
 
 
 CJsonValue* cjson_value_new(CJsonAllocator* allocator) {
     allocator = cjson_allocator_or_default(allocator);
-    CJsonValue* val = (CJsonValue*) cjson_alloc(allocator, sizeof(CJsonValue));
+    CJsonValue* val = (CJsonValue*) cjson_alloc_kind(allocator, sizeof(CJsonValue), cjson_value_allocation);
     val->_type = cjson_null_value;
+    val->_lazy_size = 0;
     val->_allocator = allocator;
     return val;
 }
 
+// Decodes a lazy value in place, for the accessors which hand its content out. Read-only functions
+// use cjson_impl_value_number and cjson_impl_value_str_bytes instead, and never write to a value.
+void cjson_impl_value_materialize(CJsonValue* this) {
+    if(this->_lazy_size == 0) { return; }
+    const char* data = this->_lazy;
+    const size_t size = this->_lazy_size;
+    this->_lazy_size = 0;
+    if(this->_type == cjson_number_value) {
+        this->_number = cjson_tokenizer_number_value(data, size);
+    }
+    else {
+        this->_str = cjson_str_new_from_bytes(data, size, this->_allocator);
+    }
+}
+
+double cjson_impl_value_number(const CJsonValue* this) {
+    return this->_lazy_size != 0 ? cjson_tokenizer_number_value(this->_lazy, this->_lazy_size) : this->_number;
+}
+
+void cjson_impl_value_str_bytes(const CJsonValue* this, const char** data, size_t* size) {
+    if(this->_lazy_size != 0) {
+        *data = this->_lazy;
+        *size = this->_lazy_size;
+        return;
+    }
+    *data = this->_str->_data;
+    *size = this->_str->_size;
+}
+
 void cjson_value_free(CJsonValue* this) {
     cjson_value_reset(this);
     cjson_dealloc(this->_allocator, this);
 }
 
+void cjson_impl_value_stack_init(CJsonImplValueStack* this) {
+    this->_data = this->_inline;
+    this->_size = 0;
+    this->_capacity = CJSON_VALUE_STACK_INLINE_SIZE;
+}
+
+bool cjson_impl_value_stack_push(CJsonImplValueStack* this, CJsonValue* value) {
+    if(this->_size == this->_capacity) {
+        const size_t capacity = this->_capacity * 2;
+        CJsonValue** data = (CJsonValue**) cjson_alloc(NULL, capacity * sizeof(CJsonValue*));
+        if(data == NULL) { return false; }
+        memcpy(data, this->_data, this->_size * sizeof(CJsonValue*));
+        if(this->_data != this->_inline) {
+            cjson_dealloc(NULL, this->_data);
+        }
+        this->_data = data;
+        this->_capacity = capacity;
+    }
+    this->_data[this->_size++] = value;
+    return true;
+}
+
+// Frees the content of a value, leaving the containers it holds to `pending`.
+void cjson_impl_value_reset_deferred(CJsonValue* this, CJsonImplValueStack* pending) {
+    if(this->_lazy_size != 0) {
+        this->_lazy_size = 0;
+    }
+    else if(cjson_value_is_object(this)) {
+        cjson_impl_object_free_deferred(this->_object, pending);
+        this->_object = NULL;
+    }
+    else if(cjson_value_is_array(this)) {
+        cjson_impl_array_free_deferred(this->_array, pending);
+        this->_array = NULL;
+    }
+    else if(cjson_value_is_str(this)) {
+        cjson_str_free(this->_str);
+        this->_str = NULL;
+    }
+    this->_type = cjson_null_value;
+}
+
+void cjson_impl_value_free_deferred(CJsonValue* value, CJsonImplValueStack* pending) {
+    if(value == NULL) { return; }
+    const bool is_container = value->_lazy_size == 0 && (cjson_value_is_object(value) || cjson_value_is_array(value));
+    if(is_container && cjson_impl_value_stack_push(pending, value)) { return; }
+    // Out of memory for the stack, the value is freed by recursing instead.
+    cjson_impl_value_reset_deferred(value, pending);
+    cjson_dealloc(value->_allocator, value);
+}
+
+void cjson_impl_value_stack_drain(CJsonImplValueStack* this) {
+    while(this->_size > 0) {
+        CJsonValue* value = this->_data[--this->_size];
+        cjson_impl_value_reset_deferred(value, this);
+        cjson_dealloc(value->_allocator, value);
+    }
+    if(this->_data != this->_inline) {
+        cjson_dealloc(NULL, this->_data);
+    }
+}
+
 CJsonValue* cjson_value_new_as_null(CJsonAllocator* allocator) {
     return cjson_value_new(allocator);
 }
@@ -63,9 +157,36 @@ CJsonValue* cjson_value_new_as_number(double number_val, CJsonAllocator* allocat
     return val;
 }
 
+CJsonValue* cjson_value_new_as_lazy_number(const char* data, size_t size, CJsonAllocator* allocator) {
+    if(size == 0 || size > UINT32_MAX) {
+        return cjson_value_new_as_number(cjson_tokenizer_number_value(data, size), allocator);
+    }
+    CJsonValue* val = cjson_value_new(allocator);
+    val->_type = cjson_number_value;
+    val->_lazy = data;
+    val->_lazy_size = (uint32_t) size;
+    return val;
+}
+
+CJsonValue* cjson_value_new_as_lazy_str(const char* data, size_t size, CJsonAllocator* allocator) {
+    if(size == 0 || size > UINT32_MAX) {
+        return cjson_value_new_as_str(cjson_str_new_from_bytes(data, size, allocator), allocator);
+    }
+    CJsonValue* val = cjson_value_new(allocator);
+    val->_type = cjson_str_value;
+    val->_lazy = data;
+    val->_lazy_size = (uint32_t) size;
+    return val;
+}
+
 CJsonValue* cjson_value_copy(const CJsonValue* const this) {
     CJsonValue* val = cjson_value_new(this->_allocator);
     val->_type = this->_type;
+    if(this->_lazy_size != 0) {
+        val->_lazy = this->_lazy;
+        val->_lazy_size = this->_lazy_size;
+        return val;
+    }
     switch(val->_type) {
         case cjson_null_value: {
             break;
@@ -95,19 +216,10 @@ CJsonValue* cjson_value_copy(const CJsonValue* const this) {
 }
 
 void cjson_value_reset(CJsonValue* this) {
-    if(cjson_value_is_object(this)) {
-        cjson_object_free(this->_object);
-        this->_object = NULL;
-    }
-    else if(cjson_value_is_array(this)) {
-        cjson_array_free(this->_array);
-        this->_array = NULL;
-    }
-    else if(cjson_value_is_str(this)) {
-        cjson_str_free(this->_str);
-        this->_str = NULL;
-    }
-    this->_type = cjson_null_value;
+    CJsonImplValueStack pending;
+    cjson_impl_value_stack_init(&pending);
+    cjson_impl_value_reset_deferred(this, &pending);
+    cjson_impl_value_stack_drain(&pending);
 }
 
 bool cjson_value_is(const CJsonValue* const this, CJsonValueType type) {
@@ -156,6 +268,7 @@ CJsonStr* cjson_value_get_str(CJsonValue* this) {
     if(!cjson_value_is_str(this)) {
         return NULL;
     }
+    cjson_impl_value_materialize(this);
     return this->_str;
 }
 
@@ -170,6 +283,7 @@ double* cjson_value_get_number(CJsonValue* this) {
     if(!cjson_value_is_number(this)) {
         return NULL;
     }
+    cjson_impl_value_materialize(this);
     return &this->_number;
 }
 
@@ -200,6 +314,7 @@ void cjson_value_make_str(CJsonValue* this, CJsonStr* str) {
         cjson_value_reset(this);
         this->_type = cjson_str_value;
     }
+    this->_lazy_size = 0;
     this->_str = str;
 }
 
@@ -216,6 +331,7 @@ void cjson_value_make_number(CJsonValue* this, double val) {
         cjson_value_reset(this);
         this->_type = cjson_number_value;
     }
+    this->_lazy_size = 0;
     this->_number = val;
 }
 
@@ -225,9 +341,20 @@ bool cjson_value_equals(const CJsonValue* this, const CJsonValue* other) {
         case cjson_null_value: return true;
         case cjson_object_value: return cjson_object_equals(this->_object, other->_object);
         case cjson_array_value: return cjson_array_equals(this->_array, other->_array);
-        case cjson_str_value: return cjson_str_equals(this->_str, other->_str);
+        case cjson_str_value: {
+            if(this->_lazy_size == 0 && other->_lazy_size == 0) {
+                return cjson_str_equals(this->_str, other->_str);
+            }
+            const char* data = NULL;
+            const char* other_data = NULL;
+            size_t size = 0;
+            size_t other_size = 0;
+            cjson_impl_value_str_bytes(this, &data, &size);
+            cjson_impl_value_str_bytes(other, &other_data, &other_size);
+            return size == other_size && memcmp(data, other_data, size) == 0;
+        }
         case cjson_bool_value: return this->_bool == other->_bool;
-        case cjson_number_value: return this->_number == other->_number;
+        case cjson_number_value: return cjson_impl_value_number(this) == cjson_impl_value_number(other);
     }
     return false;
 }
@@ -246,28 +373,12 @@ void cjson_null_fmt(CJsonStringStream* stream) {
 }
 
 void cjson_number_fmt(CJsonStringStream* stream, const double* val) {
-    cjson_string_stream_write_double(stream, val);
+    char number[CJSON_NUMBER_MAX_LENGTH];
+    cjson_string_stream_write_bytes(stream, number, cjson_impl_number_format(number, *val));
 }
 
 void cjson_value_fmt(CJsonStringStream* stream, const CJsonValue* const this) {
-    switch(this->_type) {
-        case cjson_null_value:
-            cjson_null_fmt(stream);
-            return;
-        case cjson_object_value:
-            cjson_object_fmt(stream, this->_object);
-            return;
-        case cjson_array_value:
-            cjson_array_fmt(stream, this->_array);
-            return;
-        case cjson_str_value:
-            cjson_str_fmt(stream, this->_str);
-            return;
-        case cjson_bool_value:
-            cjson_bool_fmt(stream, &this->_bool);
-            return;
-        case cjson_number_value:
-            cjson_number_fmt(stream, &this->_number);
-            return;
-    }
+    CJsonSink sink;
+    cjson_string_stream_sink_init(&sink, stream);
+    cjson_write_value(&sink, this, NULL);
 }
@@ -7,23 +7,423 @@
 //
 
 #include "cjson_allocator.h"
-#include "cjson_stringstream.h"
+#include "cjson_array.h"
+#include "cjson_assert.h"
+#include "cjson_object.h"
+#include "cjson_sink.h"
+#include "cjson_str.h"
+#include "cjson_utils.h"
 #include "cjson_value.h"
 #include "cjson_writer.h"
 
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+CJSON_STATIC_ASSERT(CJSON_WRITER_MAX_DEPTH <= CJSON_SYNTAX_MAX_DEPTH);
+
+
+size_t cjson_impl_number_format_integer(char* out, int64_t value) {
+    char digits[20];
+    size_t count = 0;
+    uint64_t magnitude = value < 0 ? -(uint64_t) value : (uint64_t) value;
+    do {
+        digits[count++] = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude != 0);
+    size_t size = 0;
+    if(value < 0) { out[size++] = '-'; }
+    while(count > 0) {
+        out[size++] = digits[--count];
+    }
+    return size;
+}
+
+// Writes `mantissa` / 10^`decimals` in fixed notation.
+size_t cjson_impl_number_format_decimal(char* out, int64_t mantissa, int decimals) {
+    char digits[CJSON_NUMBER_MAX_LENGTH];
+    const size_t count = cjson_impl_number_format_integer(digits, mantissa < 0 ? -mantissa : mantissa);
+    size_t size = 0;
+    if(mantissa < 0) { out[size++] = '-'; }
+    if(count <= (size_t) decimals) {
+        out[size++] = '0';
+        out[size++] = '.';
+        memset(out + size, '0', decimals - count);
+        size += decimals - count;
+        memcpy(out + size, digits, count);
+        return size + count;
+    }
+    const size_t integer_digits = count - decimals;
+    memcpy(out + size, digits, integer_digits);
+    size += integer_digits;
+    out[size++] = '.';
+    memcpy(out + size, digits + integer_digits, decimals);
+    return size + decimals;
+}
+
+size_t cjson_impl_number_format(char* out, double value) {
+    if(!isfinite(value)) {
+        memcpy(out, "null", 4);
+        return 4;
+    }
+    const double magnitude = fabs(value);
+    // Below 2^53 every integer is exact and prints without a fraction.
+    if(magnitude < 9007199254740992.0 && value == (double) (int64_t) value) {
+        return cjson_impl_number_format_integer(out, (int64_t) value);
+    }
+    // Where %.15g uses fixed notation, a number of at most 15 significant digits is the fewest
+    // decimals d for which some integer m gives m / 10^d back: both the division and strtod round
+    // correctly, so m / 10^d reads back as the same double, and is what %.15g prints.
+    int precision = 15;
+    if(magnitude >= 1e-4 && magnitude < 1e15) {
+        double scale = 1;
+        for(int decimals = 1; decimals <= 19; ++decimals) {
+            scale *= 10;
+            const double scaled = value * scale;
+            if(fabs(scaled) >= 1e15) { break; }
+            const int64_t mantissa = (int64_t) (scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+            if((double) mantissa / scale == value) {
+                return cjson_impl_number_format_decimal(out, mantissa, decimals);
+            }
+        }
+        // More than 15 significant digits are needed.
+        precision = 16;
+    }
+    // The fewest significant digits which read back as the same double.
+    for(; precision < 17; ++precision) {
+        const int size = snprintf(out, CJSON_NUMBER_MAX_LENGTH, "%.*g", precision, value);
+        if(strtod(out, NULL) == value) { return (size_t) size; }
+    }
+    return (size_t) snprintf(out, CJSON_NUMBER_MAX_LENGTH, "%.17g", value);
+}
+
+void cjson_number_write(CJsonSink* sink, double value) {
+    char number[CJSON_NUMBER_MAX_LENGTH];
+    cjson_sink_write(sink, number, cjson_impl_number_format(number, value));
+}
+
+// A comma, a line break and enough spaces for most indentations: pretty separators are slices of it.
+#define CJSON_IMPL_SIXTEEN_SPACES "                "
+static const char s_indentation[] = ",\n"
+    CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES
+    CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES CJSON_IMPL_SIXTEEN_SPACES;
+static const size_t s_indentation_spaces = sizeof(s_indentation) - 3;
+
+void cjson_impl_write_line(CJsonSink* sink, size_t spaces, bool comma) {
+    size_t chunk = CJSON_MIN(spaces, s_indentation_spaces);
+    cjson_sink_write(sink, comma ? s_indentation : s_indentation + 1, (comma ? 2 : 1) + chunk);
+    for(spaces -= chunk; spaces > 0; spaces -= chunk) {
+        chunk = CJSON_MIN(spaces, s_indentation_spaces);
+        cjson_sink_write(sink, s_indentation + 2, chunk);
+    }
+}
+
+void cjson_impl_write_separator(CJsonSink* sink, const CJsonWriteOptions* options, size_t depth, bool first) {
+    if(options->style == cjson_pretty_write_style) {
+        cjson_impl_write_line(sink, depth * options->indent, !first);
+    } else if(!first) {
+        cjson_sink_put(sink, ',');
+    }
+}
+
+void cjson_impl_write_closing(CJsonSink* sink, const CJsonWriteOptions* options, size_t depth) {
+    if(options->style == cjson_pretty_write_style) {
+        cjson_impl_write_line(sink, depth * options->indent, false);
+    }
+}
+
+void cjson_impl_write_key_separator(CJsonSink* sink, const CJsonWriteOptions* options) {
+    if(options->style == cjson_pretty_write_style) {
+        cjson_sink_write(sink, ": ", 2);
+    } else {
+        cjson_sink_put(sink, ':');
+    }
+}
+
+void cjson_impl_write_array(CJsonSink* sink, const CJsonArray* array, const CJsonWriteOptions* options, size_t depth) {
+    cjson_sink_put(sink, '[');
+    for(size_t i = 0; i != array->_size; ++i) {
+        cjson_impl_write_separator(sink, options, depth + 1, i == 0);
+        cjson_impl_write_value(sink, array->_data[i], options, depth + 1);
+    }
+    if(array->_size > 0) {
+        cjson_impl_write_closing(sink, options, depth);
+    }
+    cjson_sink_put(sink, ']');
+}
+
+void cjson_impl_write_object(CJsonSink* sink, const CJsonObject* object, const CJsonWriteOptions* options, size_t depth) {
+    cjson_sink_put(sink, '{');
+    CJsonObjectIterator it = cjson_object_iter_begin((CJsonObject*) object);
+    bool first = true;
+    for(; !cjson_object_iter_is_end(it); it = cjson_object_iter_next(it)) {
+        cjson_impl_write_separator(sink, options, depth + 1, first);
+        first = false;
+        cjson_raw_str_write(sink, cjson_object_iter_get_key(it));
+        cjson_impl_write_key_separator(sink, options);
+        cjson_impl_write_value(sink, cjson_object_iter_get_value(it), options, depth + 1);
+    }
+    if(!first) {
+        cjson_impl_write_closing(sink, options, depth);
+    }
+    cjson_sink_put(sink, '}');
+}
+
+void cjson_impl_write_value(CJsonSink* sink, const CJsonValue* value, const CJsonWriteOptions* options, size_t depth) {
+    if(value->_lazy_size != 0) {
+        if(value->_type == cjson_number_value) {
+            cjson_number_write(sink, cjson_impl_value_number(value));
+        } else {
+            cjson_impl_str_write_bytes(sink, value->_lazy, value->_lazy_size);
+        }
+        return;
+    }
+    switch(value->_type) {
+        case cjson_null_value: cjson_sink_write(sink, "null", 4); return;
+        case cjson_object_value: cjson_impl_write_object(sink, value->_object, options, depth); return;
+        case cjson_array_value: cjson_impl_write_array(sink, value->_array, options, depth); return;
+        case cjson_str_value: cjson_str_write(sink, value->_str); return;
+        case cjson_bool_value: {
+            if(value->_bool) {
+                cjson_sink_write(sink, "true", 4);
+            } else {
+                cjson_sink_write(sink, "false", 5);
+            }
+            return;
+        }
+        case cjson_number_value: cjson_number_write(sink, value->_number); return;
+    }
+}
+
+CJsonWriteOptions cjson_write_options_default() {
+    const CJsonWriteOptions options = {
+        .style = cjson_compact_write_style,
+        .indent = 2
+    };
+    return options;
+}
+
+void cjson_write_value(CJsonSink* sink, const CJsonValue* value, const CJsonWriteOptions* options) {
+    const CJsonWriteOptions default_options = cjson_write_options_default();
+    if(options == NULL) { options = &default_options; }
+    cjson_impl_write_value(sink, value, options, 0);
+}
+
+bool cjson_write_with_options(const CJsonValue* value, const CJsonWriteOptions* options, CJsonSink* sink) {
+    cjson_write_value(sink, value, options);
+    return cjson_sink_flush(sink);
+}
+
+bool cjson_write(const CJsonValue* value, CJsonSink* sink) {
+    return cjson_write_with_options(value, NULL, sink);
+}
+
+size_t cjson_serialized_size(const CJsonValue* value, const CJsonWriteOptions* options) {
+    // Without a buffer, every byte overflows and is only counted.
+    CJsonSink sink;
+    cjson_buffer_sink_init(&sink, NULL, 0);
+    cjson_write_value(&sink, value, options);
+    return cjson_buffer_sink_size(&sink);
+}
+
+bool cjson_write_to_buffer(const CJsonValue* value, char* buffer, size_t capacity, const CJsonWriteOptions* options, size_t* size) {
+    CJsonSink sink;
+    cjson_buffer_sink_init(&sink, buffer, capacity);
+    cjson_write_value(&sink, value, options);
+    if(size != NULL) {
+        *size = cjson_buffer_sink_size(&sink);
+    }
+    return !cjson_sink_failed(&sink);
+}
+
+// Output of cjson_to_str, grown as the sink hands bytes over.
+typedef struct CJsonStrOutput {
+    CJsonAllocator* allocator;
+    char* data;
+    size_t size;
+    size_t capacity;
+} CJsonStrOutput;
+
+bool cjson_impl_str_output_write(void* context, const char* data, size_t size) {
+    CJsonStrOutput* this = (CJsonStrOutput*) context;
+    // One byte is kept for the terminating NUL.
+    if(this->size + size >= this->capacity) {
+        const size_t capacity = CJSON_MAX(this->capacity * 2, this->size + size + 1);
+        char* grown = (char*) cjson_realloc(this->allocator, this->data, capacity);
+        if(grown == NULL) { return false; }
+        this->data = grown;
+        this->capacity = capacity;
+    }
+    memcpy(this->data + this->size, data, size);
+    this->size += size;
+    return true;
+}
+
+char* cjson_to_str_with_options(const CJsonValue* value, const CJsonWriteOptions* options, CJsonAllocator* allocator) {
+    CJsonStrOutput output = {
+        .allocator = allocator,
+        .data = (char*) cjson_alloc(allocator, CJSON_TO_STR_INITIAL_SIZE),
+        .size = 0,
+        .capacity = CJSON_TO_STR_INITIAL_SIZE
+    };
+    if(output.data == NULL) { return NULL; }
+    char buffer[CJSON_PRINT_BUFFER_SIZE];
+    CJsonSink sink;
+    cjson_sink_init(&sink, cjson_impl_str_output_write, &output, buffer, sizeof(buffer));
+    if(!cjson_write_with_options(value, options, &sink)) {
+        cjson_dealloc(allocator, output.data);
+        return NULL;
+    }
+    output.data[output.size] = '\0';
+    // Gives back what the last growth did not use.
+    char* shrunk = (char*) cjson_realloc(allocator, output.data, output.size + 1);
+    return shrunk != NULL ? shrunk : output.data;
+}
 
 char* cjson_to_str(const CJsonValue* const value, CJsonAllocator* allocator) {
-    CJsonStringStream* stream = cjson_string_stream_new(allocator);
-    cjson_value_fmt(stream, value);
-    char* buff = cjson_string_stream_str(stream);
-    cjson_string_stream_free(stream);
-    return buff;
+    return cjson_to_str_with_options(value, NULL, allocator);
+}
+
+bool cjson_impl_writer_fail(CJsonWriter* this) {
+    this->_state = cjson_syntax_error_state;
+    return false;
+}
+
+// Writes what separates the next value from the previous one. False when no value may come next.
+bool cjson_impl_writer_before_value(CJsonWriter* this) {
+    if(this->_state == cjson_syntax_separator_state && !cjson_syntax_stack_top_is_object(&this->_containers)) {
+        cjson_impl_write_separator(this->_sink, &this->_options, this->_containers.depth, false);
+        this->_state = cjson_syntax_after_comma(false);
+    }
+    else if(this->_state == cjson_syntax_first_value_state) {
+        cjson_impl_write_separator(this->_sink, &this->_options, this->_containers.depth, true);
+    }
+    return cjson_syntax_expects_value(this->_state) || cjson_impl_writer_fail(this);
+}
+
+bool cjson_impl_writer_after_value(CJsonWriter* this) {
+    this->_state = cjson_syntax_after_value(this->_containers.depth);
+    return !cjson_sink_failed(this->_sink) || cjson_impl_writer_fail(this);
+}
+
+bool cjson_impl_writer_begin(CJsonWriter* this, bool is_object) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    if(!cjson_syntax_stack_push(&this->_containers, is_object, CJSON_WRITER_MAX_DEPTH)) { return cjson_impl_writer_fail(this); }
+    cjson_sink_put(this->_sink, is_object ? '{' : '[');
+    this->_state = cjson_syntax_after_open(is_object);
+    return true;
+}
+
+bool cjson_impl_writer_end(CJsonWriter* this, bool is_object) {
+    if(this->_containers.depth == 0 || cjson_syntax_stack_top_is_object(&this->_containers) != is_object
+       || !cjson_syntax_can_close(this->_state, is_object)) {
+        return cjson_impl_writer_fail(this);
+    }
+    if(this->_state == cjson_syntax_separator_state) {
+        cjson_impl_write_closing(this->_sink, &this->_options, this->_containers.depth - 1);
+    }
+    cjson_sink_put(this->_sink, is_object ? '}' : ']');
+    cjson_syntax_stack_pop(&this->_containers);
+    return cjson_impl_writer_after_value(this);
+}
+
+void cjson_writer_init(CJsonWriter* this, CJsonSink* sink, const CJsonWriteOptions* options) {
+    this->_sink = sink;
+    this->_options = options != NULL ? *options : cjson_write_options_default();
+    this->_state = cjson_syntax_value_state;
+    cjson_syntax_stack_init(&this->_containers);
+}
+
+bool cjson_writer_begin_object(CJsonWriter* this) {
+    return cjson_impl_writer_begin(this, true);
+}
+
+bool cjson_writer_end_object(CJsonWriter* this) {
+    return cjson_impl_writer_end(this, true);
+}
+
+bool cjson_writer_begin_array(CJsonWriter* this) {
+    return cjson_impl_writer_begin(this, false);
+}
+
+bool cjson_writer_end_array(CJsonWriter* this) {
+    return cjson_impl_writer_end(this, false);
+}
+
+bool cjson_writer_key_bytes(CJsonWriter* this, const char* key, size_t size) {
+    if(this->_state == cjson_syntax_separator_state && cjson_syntax_stack_top_is_object(&this->_containers)) {
+        cjson_impl_write_separator(this->_sink, &this->_options, this->_containers.depth, false);
+        this->_state = cjson_syntax_after_comma(true);
+    }
+    else if(this->_state == cjson_syntax_first_key_state) {
+        cjson_impl_write_separator(this->_sink, &this->_options, this->_containers.depth, true);
+    }
+    if(!cjson_syntax_expects_key(this->_state)) { return cjson_impl_writer_fail(this); }
+    cjson_impl_str_write_bytes(this->_sink, key, size);
+    cjson_impl_write_key_separator(this->_sink, &this->_options);
+    // The colon is written along with the key.
+    this->_state = cjson_syntax_value_state;
+    return true;
+}
+
+bool cjson_writer_key(CJsonWriter* this, const char* key) {
+    return cjson_writer_key_bytes(this, key, strlen(key));
+}
+
+bool cjson_writer_string_bytes(CJsonWriter* this, const char* data, size_t size) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    cjson_impl_str_write_bytes(this->_sink, data, size);
+    return cjson_impl_writer_after_value(this);
+}
+
+bool cjson_writer_string(CJsonWriter* this, const char* str) {
+    return cjson_writer_string_bytes(this, str, strlen(str));
+}
+
+bool cjson_writer_number(CJsonWriter* this, double value) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    cjson_number_write(this->_sink, value);
+    return cjson_impl_writer_after_value(this);
+}
+
+bool cjson_writer_bool(CJsonWriter* this, bool value) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    if(value) {
+        cjson_sink_write(this->_sink, "true", 4);
+    } else {
+        cjson_sink_write(this->_sink, "false", 5);
+    }
+    return cjson_impl_writer_after_value(this);
+}
+
+bool cjson_writer_null(CJsonWriter* this) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    cjson_sink_write(this->_sink, "null", 4);
+    return cjson_impl_writer_after_value(this);
+}
+
+bool cjson_writer_value(CJsonWriter* this, const CJsonValue* value) {
+    if(!cjson_impl_writer_before_value(this)) { return false; }
+    cjson_impl_write_value(this->_sink, value, &this->_options, this->_containers.depth);
+    return cjson_impl_writer_after_value(this);
+}
+
+bool cjson_writer_finish(CJsonWriter* this) {
+    const bool flushed = cjson_sink_flush(this->_sink);
+    return flushed && this->_state == cjson_syntax_done_state;
+}
+
+bool cjson_writer_failed(const CJsonWriter* this) {
+    return this->_state == cjson_syntax_error_state || cjson_sink_failed(this->_sink);
 }
 
-void cjson_print(const CJsonValue* const value, CJsonAllocator* allocator) {
-    char* buff = cjson_to_str(value, allocator);
-    printf("%s\n", buff);
-    free(buff);
+void cjson_print(const CJsonValue* const value, CJSON_UNUSED CJsonAllocator* allocator) {
+    char buffer[CJSON_PRINT_BUFFER_SIZE];
+    CJsonSink sink;
+    cjson_sink_init(&sink, cjson_file_sink_write, stdout, buffer, sizeof(buffer));
+    cjson_write_value(&sink, value, NULL);
+    cjson_sink_put(&sink, '\n');
+    cjson_sink_flush(&sink);
 }
@@ -12,12 +12,24 @@
 #include <stdio.h>
 
 #include "cjson_allocator.h"
+#include "cjson_allocator_stats.h"
 #include "cjson_array.h"
+#include "cjson_array_stream.h"
 #include "cjson_assert.h"
+#include "cjson_compressed_reader.h"
+#include "cjson_cursor.h"
+#include "cjson_document.h"
+#include "cjson_events.h"
+#include "cjson_file_reader.h"
 #include "cjson_object.h"
 #include "cjson_ordering.h"
+#include "cjson_parser.h"
+#include "cjson_scanner.h"
+#include "cjson_sink.h"
 #include "cjson_str.h"
 #include "cjson_stringstream.h"
+#include "cjson_tokenizer.h"
+#include "cjson_validator.h"
 #include "cjson_value.h"
 #include "cjson_writer.h"
 #include "cjson_reader.h"
@@ -5,28 +5,197 @@
 #ifndef CJSON_CJSON_ALLOCATOR_H
 #define CJSON_CJSON_ALLOCATOR_H
 
+#include "cjson_assert.h"
+
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+
 
+typedef enum CJsonAllocatorTraits {
+    cjson_allocator_no_traits = 0,
+    // Every allocation is released at once when the allocator itself is freed; dealloc is a no-op.
+    cjson_allocator_bulk_free_trait = 1 << 0
+} CJsonAllocatorTraits;
 
+typedef enum CJsonAllocationKind {
+    cjson_other_allocation = 0,
+    cjson_value_allocation,
+    cjson_object_allocation,
+    cjson_object_node_allocation,
+    cjson_key_allocation,
+    cjson_str_allocation,
+    cjson_array_allocation,
+    cjson_array_buffer_allocation,
+    cjson_stream_block_allocation,
+    cjson_buffer_allocation,
+    cjson_reader_allocation,
+    cjson_allocation_kind_count
+} CJsonAllocationKind;
+
+// Fields may be added in later versions, meaning nothing when zero: allocators defined by users
+// must be zero initialized, with designated initializers, `= {0}` or CJSON_ALLOCATOR_INIT, before
+// setting their fields.
 typedef struct CJsonAllocator {
     void* (*alloc)(void* context, size_t size);
     void* (*realloc)(void* context, void* address, size_t size);
     void (*dealloc)(void* context, void* address);
     void* context;
+    unsigned int traits;
+    // Optional, used instead of alloc by allocators which account for what is being allocated.
+    void* (*alloc_kind)(void* context, size_t size, CJsonAllocationKind kind);
 } CJsonAllocator;
 
+// Allocator without traits which does not account for the kinds of its allocations.
+#define CJSON_ALLOCATOR_INIT(alloc_function, realloc_function, dealloc_function, allocator_context) \
+    ((CJsonAllocator) { \
+        .alloc = (alloc_function), \
+        .realloc = (realloc_function), \
+        .dealloc = (dealloc_function), \
+        .context = (allocator_context), \
+        .traits = cjson_allocator_no_traits, \
+        .alloc_kind = NULL \
+    })
+
 CJsonAllocator* cjson_allocator_get_default();
 
 CJsonAllocator* cjson_allocator_or_default(CJsonAllocator* allocator);
 
+typedef enum CJsonMappedArenaFlags {
+    cjson_mapped_arena_no_flags = 0,
+    // Ask for transparent huge pages on committed memory (madvise(MADV_HUGEPAGE)).
+    cjson_mapped_arena_huge_pages = 1 << 0,
+    // Commit explicit huge pages (MAP_HUGETLB), falling back to regular pages when none are available.
+    cjson_mapped_arena_hugetlb = 1 << 1,
+    // Prefault memory as it gets committed (MAP_POPULATE) instead of on first touch.
+    cjson_mapped_arena_populate = 1 << 2
+} CJsonMappedArenaFlags;
+
+// Address space reserved for mapped arenas whose final size is not known in advance.
+#ifndef CJSON_ARENA_RESERVE
+#define CJSON_ARENA_RESERVE ((size_t) 1 << 34)
+#endif
+
 CJsonAllocator* cjson_linear_allocator_new(size_t size);
 
+// A linear allocator whose pool is a reservation of `reserve_size` bytes of address space,
+// committed `commit_step` bytes at a time as the arena fills up (0 selects the default step).
+CJsonAllocator* cjson_mapped_linear_allocator_new(size_t reserve_size, size_t commit_step, unsigned int flags);
+
 void cjson_linear_allocator_free(CJsonAllocator* allocator);
 
+// Releases every allocation at once, keeping the pool, committed pages included, for reuse.
+void cjson_linear_allocator_reset(CJsonAllocator* allocator);
+
+bool cjson_allocator_has_trait(const CJsonAllocator* allocator, CJsonAllocatorTraits trait);
+
+bool cjson_allocator_has_bulk_free(const CJsonAllocator* allocator);
+
 void* cjson_alloc(CJsonAllocator* allocator, size_t size);
 
+void* cjson_alloc_kind(CJsonAllocator* allocator, size_t size, CJsonAllocationKind kind);
+
 void* cjson_realloc(CJsonAllocator* allocator, void* address, size_t size);
 
 void cjson_dealloc(CJsonAllocator* allocator, void* address);
 
+void* cjson_default_alloc(void* context, size_t size);
+void* cjson_default_realloc(void* context, void* address, size_t size);
+void cjson_default_dealloc(void* context, void* address);
+
+void* cjson_linear_allocator_alloc(void* context, size_t size);
+void* cjson_linear_allocator_realloc(void* context, void* address, size_t size);
+void cjson_linear_allocator_dealloc(void* context, void* address);
+
+#define CJSON_LINEAR_ALLOCATOR_ALIGNMENT (_Alignof(max_align_t))
+
+typedef struct CJsonLinearAllocatorContext {
+    char* pool;
+    char* head;
+    size_t size;
+    size_t capacity;
+    // Mapped pools only: capacity is the committed part of a `reserved` bytes reservation.
+    bool mapped;
+    size_t reserved;
+    size_t commit_step;
+    unsigned int flags;
+} CJsonLinearAllocatorContext;
+
+// Aligned like the allocations it precedes, and so padded to a multiple of their alignment.
+typedef struct CJsonLinearAllocatorBlockHeader {
+    _Alignas(max_align_t) char* start_ptr;
+    char* end_ptr;
+} CJsonLinearAllocatorBlockHeader;
+
+CJSON_STATIC_ASSERT(sizeof(CJsonLinearAllocatorBlockHeader) % CJSON_LINEAR_ALLOCATOR_ALIGNMENT == 0);
+
+static inline size_t cjson_impl_linear_allocator_align(size_t size) {
+    return (size + CJSON_LINEAR_ALLOCATOR_ALIGNMENT - 1) & ~(CJSON_LINEAR_ALLOCATOR_ALIGNMENT - 1);
+}
+
+// Footprint in the pool of a single allocation of `size` bytes.
+static inline size_t cjson_linear_allocator_block_size(size_t size) {
+    return sizeof(CJsonLinearAllocatorBlockHeader) + cjson_impl_linear_allocator_align(size);
+}
+
+bool cjson_impl_linear_allocator_grow(CJsonLinearAllocatorContext* this, size_t min_free_bytes);
+
+static inline void* cjson_impl_linear_allocator_bump(CJsonLinearAllocatorContext* this, size_t size) {
+    const size_t block_size = cjson_linear_allocator_block_size(size);
+    if(block_size > (this->capacity - this->size)
+       && !cjson_impl_linear_allocator_grow(this, block_size)) {
+        return NULL;
+    }
+    CJsonLinearAllocatorBlockHeader* block_header = (CJsonLinearAllocatorBlockHeader*) this->head;
+    block_header->start_ptr = this->head + sizeof(CJsonLinearAllocatorBlockHeader);
+    block_header->end_ptr = this->head + block_size;
+    this->head += block_size;
+    this->size += block_size;
+    return block_header->start_ptr;
+}
+
+#ifdef CJSON_ENABLE_INLINE_ALLOCATOR
+
+// The default and linear allocators are recognised by their entry points and
+// served inline, other allocators go through the out-of-line dispatch.
+
+static inline void* cjson_impl_inline_alloc_kind(CJsonAllocator* this, size_t size, CJsonAllocationKind kind) {
+    if(this == NULL || this->alloc == cjson_default_alloc) {
+        return malloc(size);
+    }
+    if(this->alloc == cjson_linear_allocator_alloc) {
+        return cjson_impl_linear_allocator_bump((CJsonLinearAllocatorContext*) this->context, size);
+    }
+    return (cjson_alloc_kind)(this, size, kind);
+}
+
+static inline void* cjson_impl_inline_realloc(CJsonAllocator* this, void* address, size_t size) {
+    if(this == NULL || this->realloc == cjson_default_realloc) {
+        return realloc(address, size);
+    }
+    return (cjson_realloc)(this, address, size);
+}
+
+static inline void cjson_impl_inline_dealloc(CJsonAllocator* this, void* address) {
+    if(this == NULL || this->dealloc == cjson_default_dealloc) {
+        free(address);
+        return;
+    }
+    if(this->dealloc == cjson_linear_allocator_dealloc) {
+        return;
+    }
+    (cjson_dealloc)(this, address);
+}
+
+#define cjson_alloc(allocator, size) \
+    cjson_impl_inline_alloc_kind(allocator, size, cjson_other_allocation)
+#define cjson_alloc_kind(allocator, size, kind) \
+    cjson_impl_inline_alloc_kind(allocator, size, kind)
+#define cjson_realloc(allocator, address, size) \
+    cjson_impl_inline_realloc(allocator, address, size)
+#define cjson_dealloc(allocator, address) \
+    cjson_impl_inline_dealloc(allocator, address)
+
+#endif
+
 #endif //CJSON_CJSON_ALLOCATOR_H
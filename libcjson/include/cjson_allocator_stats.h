@@ -0,0 +1,41 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_ALLOCATOR_STATS_H
+#define CJSON_CJSON_ALLOCATOR_STATS_H
+
+#include "cjson_allocator.h"
+
+#include <stdlib.h>
+
+
+typedef struct CJsonStringStream CJsonStringStream;
+
+typedef struct CJsonAllocationCounters {
+    size_t allocs;
+    size_t reallocs;
+    size_t deallocs;
+    size_t allocated_bytes;
+    size_t live_bytes;
+} CJsonAllocationCounters;
+
+typedef struct CJsonAllocatorStats {
+    CJsonAllocationCounters total;
+    size_t peak_bytes;
+    CJsonAllocationCounters by_kind[cjson_allocation_kind_count];
+} CJsonAllocatorStats;
+
+// Wraps an allocator and records what goes through it. Like the allocators it
+// wraps, a stats allocator is not thread safe and must not be shared between threads.
+CJsonAllocator* cjson_stats_allocator_new(CJsonAllocator* inner);
+void cjson_stats_allocator_free(CJsonAllocator* allocator);
+
+const CJsonAllocatorStats* cjson_allocator_stats(const CJsonAllocator* allocator);
+void cjson_allocator_stats_reset(CJsonAllocator* allocator);
+
+const char* cjson_allocation_kind_name(CJsonAllocationKind kind);
+
+void cjson_allocator_stats_fmt(CJsonStringStream* stream, const CJsonAllocatorStats* stats);
+
+#endif //CJSON_CJSON_ALLOCATOR_STATS_H
@@ -27,6 +27,7 @@ typedef struct CJsonArray {
 } CJsonArray;
 
 CJsonArray* cjson_array_new(CJsonAllocator* allocator);
+CJsonArray* cjson_array_new_with_capacity(size_t capacity, CJsonAllocator* allocator);
 CJsonArray* cjson_array_copy(CJsonArray* this);
 void cjson_array_free(CJsonArray* this);
 
@@ -51,6 +52,10 @@ bool cjson_array_equals(CJsonArray* this, CJsonArray* other);
 
 void cjson_array_fmt(CJsonStringStream* stream, CJsonArray* this);
 
+typedef struct CJsonImplValueStack CJsonImplValueStack;
+// Frees the array, leaving the elements which hold containers to `pending`.
+void cjson_impl_array_free_deferred(CJsonArray* this, CJsonImplValueStack* pending);
+
 CJsonArray* cjson_impl_array_builder(CJsonAllocator* allocator, size_t items, ...);
 
 #define CJSON_EMPTY_ARRAY_A(allocator) cjson_array_new(allocator)
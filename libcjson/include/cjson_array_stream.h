@@ -0,0 +1,44 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_ARRAY_STREAM_H
+#define CJSON_CJSON_ARRAY_STREAM_H
+
+#include "cjson_value.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonImplArrayStream CJsonImplArrayStream;
+
+typedef struct CJsonArrayStreamOptions {
+    // Bytes read from the file at a time. The window holding the input grows past it to fit the
+    // largest element.
+    size_t window_size;
+    // Deepest nesting of arrays and objects accepted within an element, 0 for no limit.
+    size_t max_depth;
+} CJsonArrayStreamOptions;
+
+// Reads the elements of a document whose root is an array one at a time. Every element is parsed
+// from a window over the input into an arena which is reset for the next one, so that memory use
+// is bounded by the largest element rather than by the whole array.
+typedef struct CJsonArrayStream {
+    CJsonImplArrayStream* _impl;
+} CJsonArrayStream;
+
+CJsonArrayStreamOptions cjson_array_stream_options_default();
+
+// Reads the file `fd` from its current position; it is left open when the stream is closed.
+CJsonArrayStream* cjson_array_stream_open_fd(int fd, const CJsonArrayStreamOptions* options);
+// `data` must outlive the stream.
+CJsonArrayStream* cjson_array_stream_open_buffer(const char* data, size_t size, const CJsonArrayStreamOptions* options);
+void cjson_array_stream_close(CJsonArrayStream* this);
+
+// Moves to the next element, which lives until the following call. Returns false at the end of
+// the array, or when the input is malformed or could not be read.
+bool cjson_array_stream_next(CJsonArrayStream* this, CJsonValue** value);
+bool cjson_array_stream_failed(const CJsonArrayStream* this);
+
+#endif //CJSON_CJSON_ARRAY_STREAM_H
@@ -0,0 +1,47 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_COMPRESSED_READER_H
+#define CJSON_CJSON_COMPRESSED_READER_H
+
+#include "cjson_value.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonAllocator CJsonAllocator;
+
+typedef enum CJsonCompression {
+    // Told from the first bytes of the input, which is read as is when they match no format.
+    cjson_auto_compression = 0,
+    cjson_no_compression,
+    // gzip and zlib streams; gzip members may follow each other. Needs CJSON_ENABLE_ZLIB.
+    cjson_gzip_compression,
+    // zstd frames, which may follow each other. Needs CJSON_ENABLE_ZSTD.
+    cjson_zstd_compression
+} CJsonCompression;
+
+typedef struct CJsonCompressedReadOptions {
+    CJsonCompression compression;
+    // Size of the blocks of decompressed input fed to the parser.
+    size_t block_size;
+    // Blocks decompressed ahead of the parser, which bound the memory used.
+    size_t block_count;
+    // Decompresses on a thread of its own while the calling thread parses.
+    bool threaded;
+    // Deepest nesting of arrays and objects accepted, 0 for no limit.
+    size_t max_depth;
+} CJsonCompressedReadOptions;
+
+CJsonCompressedReadOptions cjson_compressed_read_options_default();
+
+// Reads a compressed document without ever holding it whole: it is decompressed block by block into
+// the push parser. NULL when the input is malformed, truncated, or compressed in a format this
+// build cannot read.
+CJsonValue* cjson_read_compressed(const char* data, size_t size, const CJsonCompressedReadOptions* options, CJsonAllocator* allocator);
+// Reads the file `fd` from its current position; it is left open.
+CJsonValue* cjson_read_compressed_fd(int fd, const CJsonCompressedReadOptions* options, CJsonAllocator* allocator);
+
+#endif //CJSON_CJSON_COMPRESSED_READER_H
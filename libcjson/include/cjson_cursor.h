@@ -0,0 +1,52 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_CURSOR_H
+#define CJSON_CJSON_CURSOR_H
+
+#include "cjson_value.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonAllocator CJsonAllocator;
+
+// On-demand access to a document: a cursor points at a value of the input and only reads the
+// bytes needed to answer the calls made on it. Values stepped over are skipped as a whole,
+// without being validated.
+typedef struct CJsonCursor {
+    const char* _value;
+    const char* _end;
+} CJsonCursor;
+
+void cjson_cursor_init(CJsonCursor* this, const char* data, size_t size);
+
+// Type of the value under the cursor, false on input which starts no value.
+bool cjson_cursor_type(const CJsonCursor* this, CJsonValueType* type);
+
+// Moves to the value of member `key` of the object under the cursor. The cursor is left
+// untouched when the member does not exist.
+bool cjson_cursor_find_field(CJsonCursor* this, const char* key);
+
+// Moves to the first element of the array under the cursor, then to the next element of the
+// same array. Both return false, leaving the cursor untouched, at the end of the array.
+bool cjson_cursor_first_element(CJsonCursor* this);
+bool cjson_cursor_next_element(CJsonCursor* this);
+
+bool cjson_cursor_get_double(const CJsonCursor* this, double* value);
+bool cjson_cursor_get_bool(const CJsonCursor* this, bool* value);
+bool cjson_cursor_is_null(const CJsonCursor* this);
+// Raw content of the string under the cursor, escape sequences included.
+bool cjson_cursor_get_string(const CJsonCursor* this, const char** data, size_t* size);
+
+// Builds the value under the cursor, NULL when it is malformed.
+CJsonValue* cjson_cursor_read_value(const CJsonCursor* this, CJsonAllocator* allocator);
+
+// End of the value starting at `cursor`, NULL when it is not terminated before `end`.
+const char* cjson_impl_cursor_skip_value(const char* cursor, const char* end);
+// Position of the next token after `cursor` if it is `c`, NULL otherwise.
+const char* cjson_impl_cursor_expect(const char* cursor, const char* end, char c);
+
+#endif //CJSON_CJSON_CURSOR_H
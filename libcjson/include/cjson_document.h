@@ -0,0 +1,62 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_DOCUMENT_H
+#define CJSON_CJSON_DOCUMENT_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonValue CJsonValue;
+typedef struct CJsonAllocator CJsonAllocator;
+typedef struct CJsonReadOptions CJsonReadOptions;
+typedef struct CJsonFileInput CJsonFileInput;
+
+// A document owns an arena and the value tree allocated from it: freeing the
+// document releases the whole tree in one step, without visiting any node.
+typedef struct CJsonDocument {
+    CJsonValue* _root;
+    CJsonAllocator* _allocator;
+    // Arenas of the threads which read parts of the tree, see cjson_document_read_parallel.
+    CJsonAllocator** _arenas;
+    size_t _arena_count;
+    // File the tree may borrow from, see cjson_document_read_file.
+    CJsonFileInput* _input;
+} CJsonDocument;
+
+typedef struct CJsonParallelReadOptions {
+    // Parsing threads, 0 for one per online CPU.
+    size_t threads;
+    // Smallest part of the input worth a thread of its own: smaller inputs are read by fewer threads.
+    size_t min_slice_size;
+    // Deepest nesting of arrays and objects accepted, 0 for no limit.
+    size_t max_depth;
+} CJsonParallelReadOptions;
+
+CJsonParallelReadOptions cjson_parallel_read_options_default();
+
+CJsonDocument* cjson_document_new(size_t arena_size);
+// Takes `arena` over, which must be a linear allocator. On failure, NULL is returned and `arena`
+// is left to the caller, whatever the cause.
+CJsonDocument* cjson_document_new_with_arena(CJsonAllocator* arena);
+CJsonDocument* cjson_document_read(char* data, size_t arena_size);
+// Sizes the arena from a first pass over `data`, so that it holds exactly the tree read from it.
+CJsonDocument* cjson_document_read_presized(char* data);
+// Like cjson_read_file, except that the file stays mapped, or buffered, until the document is freed:
+// `lazy` and `in_situ` values may borrow from it. In situ reads never write to the file. The arena
+// reserves address space in proportion to the size of the file, on transparent huge pages.
+CJsonDocument* cjson_document_read_file(const char* path, const CJsonReadOptions* options);
+// Reads a document whose root is an array on several threads. A scan of the input finds the
+// elements of the root, which are split into contiguous slices of about the same size; every slice
+// is parsed by a thread into an arena of its own, and the root array is put together from them.
+// Other roots are read by the calling thread. `data` is left untouched.
+CJsonDocument* cjson_document_read_parallel(const char* data, size_t size, const CJsonParallelReadOptions* options);
+void cjson_document_free(CJsonDocument* this);
+
+CJsonValue* cjson_document_root(CJsonDocument* this);
+void cjson_document_set_root(CJsonDocument* this, CJsonValue* root);
+CJsonAllocator* cjson_document_allocator(CJsonDocument* this);
+
+#endif //CJSON_CJSON_DOCUMENT_H
@@ -0,0 +1,35 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_EVENTS_H
+#define CJSON_CJSON_EVENTS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifndef CJSON_EVENTS_MAX_DEPTH
+#define CJSON_EVENTS_MAX_DEPTH 1024
+#endif
+
+
+// Callbacks of the event reader, any of them may be NULL. Returning false stops the reading.
+// Keys and strings are spans of the input, escape sequences are left as they are.
+typedef struct CJsonHandler {
+    bool (*start_object)(void* context);
+    bool (*end_object)(void* context);
+    bool (*start_array)(void* context);
+    bool (*end_array)(void* context);
+    bool (*key)(void* context, const char* data, size_t size);
+    bool (*string)(void* context, const char* data, size_t size);
+    bool (*number)(void* context, double value);
+    bool (*boolean)(void* context, bool value);
+    bool (*null)(void* context);
+} CJsonHandler;
+
+// Reports the document to `handler` as it is read, without building any value nor allocating.
+// Returns false when the input is malformed, nested deeper than CJSON_EVENTS_MAX_DEPTH, or when
+// a callback stopped the reading.
+bool cjson_read_events(const char* data, size_t size, const CJsonHandler* handler, void* context);
+
+#endif //CJSON_CJSON_EVENTS_H
@@ -0,0 +1,50 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_FILE_READER_H
+#define CJSON_CJSON_FILE_READER_H
+
+#include "cjson_reader.h"
+#include "cjson_value.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonAllocator CJsonAllocator;
+
+typedef struct CJsonFileRecord {
+    // Position of the file in the list read.
+    size_t index;
+    const char* path;
+    // NULL when the file could not be read, or is not a valid document.
+    CJsonValue* value;
+    // errno value of the failed open or read, 0 otherwise.
+    int error;
+} CJsonFileRecord;
+
+// The value is handed over to the handler, which frees it. Returning false stops the reading.
+typedef bool (*CJsonFileHandler)(void* context, const CJsonFileRecord* record);
+
+typedef struct CJsonReadFilesOptions {
+    // Files being read at the same time.
+    size_t queue_depth;
+    // Reads files through io_uring when the kernel supports it, or else on a pool of threads.
+    bool io_uring;
+    // Threads of the pool, 0 for one per online CPU.
+    size_t threads;
+    // `lazy` and `in_situ` are ignored: file buffers are reused as soon as they are read.
+    CJsonReadOptions read_options;
+} CJsonReadFilesOptions;
+
+CJsonReadFilesOptions cjson_read_files_options_default();
+
+// Reads many files, each holding a document. Opens and reads are submitted in batches, and every
+// file is parsed on the calling thread as soon as its content is in, while others are still being
+// read. Records are handed over in the order files complete. Returns false when the handler
+// asked to stop.
+bool cjson_read_files(const char* const* paths, size_t count, const CJsonReadFilesOptions* options,
+                      CJsonFileHandler handler, void* context, CJsonAllocator* allocator);
+
+#endif //CJSON_CJSON_FILE_READER_H
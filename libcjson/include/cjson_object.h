@@ -29,6 +29,7 @@ typedef struct CJsonObject {
 } CJsonObject;
 
 CJsonObject* cjson_object_new(CJsonAllocator* allocator);
+CJsonObject* cjson_object_new_with_capacity(size_t capacity, CJsonAllocator* allocator);
 CJsonObject* cjson_object_copy(CJsonObject* this);
 void cjson_object_free(CJsonObject* this);
 
@@ -47,8 +48,16 @@ CJsonValue* cjson_object_iter_get_value(CJsonObjectIterator it);
 
 bool cjson_object_equals(CJsonObject* this, CJsonObject* other);
 
+// Bytes used in a linear allocator by an empty object of the given capacity, and by each member.
+size_t cjson_object_arena_size(size_t capacity);
+size_t cjson_object_member_arena_size(size_t key_length);
+
 void cjson_object_fmt(CJsonStringStream* stream, CJsonObject* this);
 
+typedef struct CJsonImplValueStack CJsonImplValueStack;
+// Frees the object, leaving the values which hold containers to `pending`.
+void cjson_impl_object_free_deferred(CJsonObject* this, CJsonImplValueStack* pending);
+
 CJsonObject* cjson_impl_object_builder(CJsonAllocator* allocator, size_t kvs, ...);
 
 #define CJSON_EMPTY_OBJECT_A(allocator) (cjson_object_new(allocator))
@@ -0,0 +1,96 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_PARSER_H
+#define CJSON_CJSON_PARSER_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonValue CJsonValue;
+typedef struct CJsonAllocator CJsonAllocator;
+typedef struct CJsonImplParser CJsonImplParser;
+
+typedef enum CJsonParseError {
+    cjson_no_parse_error = 0,
+    // The input is not valid JSON.
+    cjson_syntax_parse_error,
+    // One of the budgets of the parser was exceeded, see CJsonParserLimits.
+    cjson_depth_parse_error,
+    cjson_size_parse_error,
+    cjson_string_length_parse_error,
+    cjson_value_count_parse_error,
+    cjson_memory_parse_error
+} CJsonParseError;
+
+// Budgets for untrusted input, each 0 for no limit. Parsing fails as soon as one is exceeded,
+// before the offending value is allocated.
+typedef struct CJsonParserLimits {
+    // Bytes of input fed.
+    size_t max_size;
+    // Longest string, key or number, in bytes of input.
+    size_t max_string_length;
+    // Values in the tree, containers included.
+    size_t max_values;
+    // Bytes taken by the tree: values, string and key bytes and container slots. Allocator
+    // overhead is not counted.
+    size_t max_memory;
+} CJsonParserLimits;
+
+// Push parser: the document is fed in chunks of any size, as they arrive, and the value tree
+// is built incrementally. Tokens split across chunks are carried over to the next feed.
+typedef struct CJsonParser {
+    CJsonImplParser* _impl;
+    CJsonAllocator* _allocator;
+} CJsonParser;
+
+CJsonParser* cjson_parser_new(CJsonAllocator* allocator);
+void cjson_parser_free(CJsonParser* this);
+
+// Gets the parser ready for a new document whose values come from `allocator`, releasing any
+// partial tree. The parser's own buffers are kept, so that a warm parser does not allocate.
+void cjson_parser_reset(CJsonParser* this, CJsonAllocator* allocator);
+
+// Deepest nesting of arrays and objects accepted, 0 for no limit.
+void cjson_parser_set_max_depth(CJsonParser* this, size_t max_depth);
+// NULL lifts every limit.
+void cjson_parser_set_limits(CJsonParser* this, const CJsonParserLimits* limits);
+
+// Numbers and strings read in lazy mode point into the fed chunks and are decoded on first
+// access, see cjson_value_new_as_lazy_number: the chunks must then outlive the tree. Tokens split
+// across chunks are decoded right away.
+void cjson_parser_set_lazy(CJsonParser* this, bool lazy);
+
+// Returns false as soon as the input seen so far cannot be valid JSON; further feeds are ignored.
+bool cjson_parser_feed(CJsonParser* this, const char* chunk, size_t size);
+
+// Signals the end of input and hands the root value over to the caller, NULL if the document
+// is malformed or incomplete.
+CJsonValue* cjson_parser_finish(CJsonParser* this);
+
+// Parses a whole document at once, like a single feed followed by finish.
+CJsonValue* cjson_parser_read(CJsonParser* this, const char* data, size_t size);
+
+// Number of bytes consumed so far, or the offset of the offending byte once parsing failed.
+size_t cjson_parser_offset(const CJsonParser* this);
+bool cjson_parser_failed(const CJsonParser* this);
+// Why parsing failed, cjson_no_parse_error while it has not.
+CJsonParseError cjson_parser_error(const CJsonParser* this);
+
+// Pool of reset parsers kept by each thread. Released parsers are reset to the default allocator,
+// no limits and eager decoding; parsers beyond the pool capacity, and parsers made by
+// cjson_parser_new with an allocator other than the default one, are freed.
+CJsonParser* cjson_parser_acquire();
+void cjson_parser_release(CJsonParser* this);
+// Frees the idle parsers of the calling thread, which otherwise happens when it exits.
+void cjson_parser_pool_clear();
+
+// Reads a whole document whose strings borrow `data`, see CJsonReadOptions.in_situ.
+CJsonValue* cjson_impl_parser_read_in_situ(CJsonParser* this, char* data, size_t size);
+
+// Element counts of the containers of the next document, in the order they open.
+void cjson_impl_parser_presize(CJsonParser* this, const size_t* container_sizes, size_t count);
+
+#endif //CJSON_CJSON_PARSER_H
@@ -0,0 +1,27 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_PROJECTION_H
+#define CJSON_CJSON_PROJECTION_H
+
+#include "cjson_value.h"
+
+#include <stdlib.h>
+
+
+typedef struct CJsonAllocator CJsonAllocator;
+
+// Reads only the parts of a document selected by a set of JSON Pointers (RFC 6901), such as
+// "/user/id". A `*` token selects every member of an object or every element of an array, as in
+// "/items/*/price". Containers on the way to a selected value are rebuilt with only the members
+// leading to it; arrays keep their selected elements in order, without gaps.
+//
+// Subtrees outside every path are skipped at scanning speed, without allocating or being
+// validated. An empty pointer selects the whole document.
+//
+// Returns NULL when a pointer or the document is malformed. A document matching no path gives an
+// empty container of the type of its root, or null for a scalar root.
+CJsonValue* cjson_read_projected(const char* data, size_t size, const char* const* paths, size_t count, CJsonAllocator* allocator);
+
+#endif //CJSON_CJSON_PROJECTION_H
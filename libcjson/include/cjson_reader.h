@@ -9,11 +9,69 @@
 #ifndef cjson_reader_h
 #define cjson_reader_h
 
+#include "cjson_parser.h"
 #include "cjson_value.h"
 
+#include <stdlib.h>
+#include <stdbool.h>
+
 
 typedef struct CJsonAllocator CJsonAllocator;
 
+typedef struct CJsonReadOptions {
+    // Deepest nesting of arrays and objects accepted, 0 for no limit.
+    size_t max_depth;
+    // Count the elements of every container in a first pass, see cjson_read_presized.
+    bool presize;
+    // Leave numbers and strings undecoded until first accessed. They point into `data`, which
+    // must then outlive the tree. The getters decode values in place: threads sharing a lazy tree
+    // must stick to functions taking const values, see cjson_value_new_as_lazy_number.
+    bool lazy;
+    // Strings borrow their bytes from `data`, which must outlive the tree: each one is decoded in
+    // place and NUL terminated over its closing quote, leaving `data` unfit for reading again.
+    bool in_situ;
+    // Budgets for untrusted input, each 0 for no limit, see CJsonParserLimits. The size budget is
+    // checked before any byte is read.
+    size_t max_size;
+    size_t max_string_length;
+    size_t max_values;
+    size_t max_memory;
+} CJsonReadOptions;
+
+CJsonReadOptions cjson_read_options_default();
+
 CJsonValue* cjson_read(char* data, CJsonAllocator* allocator);
+CJsonValue* cjson_read_with_options(char* data, const CJsonReadOptions* options, CJsonAllocator* allocator);
+// Reads the `size` bytes at `data`, which need no NUL terminator.
+CJsonValue* cjson_read_bytes(char* data, size_t size, const CJsonReadOptions* options, CJsonAllocator* allocator);
+// Like cjson_read_bytes, telling in `error` why the read failed, if it did.
+CJsonValue* cjson_read_bytes_with_error(char* data, size_t size, const CJsonReadOptions* options, CJsonAllocator* allocator, CJsonParseError* error);
+
+// Reads the file at `path`, which needs no NUL terminator. Regular files are mapped, with the
+// kernel asked to read ahead of the parser; other files, such as pipes, are read into a buffer
+// first. The file is released before returning, so `lazy` and `in_situ` are ignored: see
+// cjson_document_read_file to keep values borrowing from it.
+CJsonValue* cjson_read_file(const char* path, const CJsonReadOptions* options, CJsonAllocator* allocator);
+
+// Counts the elements of every container before reading, so that arrays and objects are
+// allocated once at their final size.
+CJsonValue* cjson_read_presized(char* data, CJsonAllocator* allocator);
+
+// Number of bytes a linear allocator needs to hold the tree read from `data`, 0 if malformed. It
+// is exact unless strings hold escape sequences, which take less room once decoded.
+size_t cjson_read_arena_size(const char* data);
+
+// Whole content of a file read by cjson_read_file: a private mapping for regular files, a buffer
+// otherwise. Writable inputs may be read in situ.
+typedef struct CJsonFileInput {
+    char* data;
+    size_t size;
+    bool is_mapped;
+} CJsonFileInput;
+
+bool cjson_impl_file_input_open(CJsonFileInput* this, const char* path, bool writable);
+// Reads what is left of `fd` into a buffer.
+bool cjson_impl_file_input_read(CJsonFileInput* this, int fd);
+void cjson_impl_file_input_close(CJsonFileInput* this);
 
 #endif /* cjson_reader_h */
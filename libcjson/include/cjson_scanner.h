@@ -0,0 +1,21 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_SCANNER_H
+#define CJSON_CJSON_SCANNER_H
+
+#include <stdlib.h>
+
+
+// Returns the closing quote of the string whose content starts at `cursor`, or NULL when the
+// string is not terminated before `end`.
+const char* cjson_scan_string_end(const char* cursor, const char* end);
+
+// Returns the first of `"`, `\`, a control character or a non-ASCII byte in [cursor, end), or `end`.
+const char* cjson_scan_string_special(const char* cursor, const char* end);
+
+// Returns the first of `"`, `{`, `}`, `[`, `]`, `,` and `:` in [cursor, end), or `end`.
+const char* cjson_scan_structural(const char* cursor, const char* end);
+
+#endif //CJSON_CJSON_SCANNER_H
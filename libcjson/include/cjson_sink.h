@@ -0,0 +1,87 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_SINK_H
+#define CJSON_CJSON_SINK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+typedef struct CJsonAllocator CJsonAllocator;
+typedef struct CJsonStringStream CJsonStringStream;
+
+// Hands `size` bytes of output over to their destination. Returning false fails the sink.
+typedef bool (*CJsonSinkWrite)(void* context, const char* data, size_t size);
+
+// Destination of serialized output. Bytes gather in a fixed-size buffer, handed over whenever it
+// fills up and on flush; writes larger than the buffer go straight through. Once a write failed,
+// everything else written to the sink is dropped.
+typedef struct CJsonSink {
+    CJsonSinkWrite _write;
+    void* _context;
+    char* _buffer;
+    size_t _size;
+    size_t _capacity;
+    bool _failed;
+    // Buffer sinks only: bytes written past the end of the buffer.
+    size_t _overflow;
+    // Owner of the buffer and of the sink itself, NULL when both belong to the caller.
+    CJsonAllocator* _allocator;
+} CJsonSink;
+
+// Sets up a sink in storage of the caller's, buffering in its `capacity` bytes at `buffer`. A
+// capacity of 0 hands every write straight over.
+void cjson_sink_init(CJsonSink* this, CJsonSinkWrite write, void* context, char* buffer, size_t capacity);
+// Sink writing into the `capacity` bytes at `buffer`, which belong to the caller, and nowhere else:
+// it fails once they are full, counting the bytes which did not fit. Flushing does nothing.
+void cjson_buffer_sink_init(CJsonSink* this, char* buffer, size_t capacity);
+// Bytes written to a buffer sink, including those which did not fit.
+size_t cjson_buffer_sink_size(const CJsonSink* this);
+// Unbuffered sink appending to `stream`.
+void cjson_string_stream_sink_init(CJsonSink* this, CJsonStringStream* stream);
+
+// NULL when out of memory.
+CJsonSink* cjson_sink_new(CJsonSinkWrite write, void* context, CJsonAllocator* allocator);
+// Writes to a file descriptor, which is left open.
+CJsonSink* cjson_fd_sink_new(int fd, CJsonAllocator* allocator);
+// Writes to a stream, which is neither flushed nor closed.
+CJsonSink* cjson_file_sink_new(FILE* file, CJsonAllocator* allocator);
+// Bytes still buffered are lost: flush first.
+void cjson_sink_free(CJsonSink* this);
+
+// Hands the buffered bytes over. False once the sink failed.
+bool cjson_sink_flush(CJsonSink* this);
+bool cjson_sink_failed(const CJsonSink* this);
+
+// Write callbacks of the built-in sinks: `context` is the file descriptor, cast to a pointer, the
+// FILE*, or the CJsonStringStream*.
+bool cjson_fd_sink_write(void* context, const char* data, size_t size);
+bool cjson_file_sink_write(void* context, const char* data, size_t size);
+bool cjson_string_stream_sink_write(void* context, const char* data, size_t size);
+
+void cjson_impl_sink_write_slow(CJsonSink* this, const char* data, size_t size);
+
+static inline void cjson_sink_write(CJsonSink* this, const char* data, size_t size) {
+    // Unbuffered sinks have a NULL buffer, which memcpy may not be given even for no bytes.
+    if(size == 0) { return; }
+    if(size <= this->_capacity - this->_size) {
+        memcpy(this->_buffer + this->_size, data, size);
+        this->_size += size;
+        return;
+    }
+    cjson_impl_sink_write_slow(this, data, size);
+}
+
+static inline void cjson_sink_put(CJsonSink* this, char c) {
+    if(this->_size < this->_capacity) {
+        this->_buffer[this->_size++] = c;
+        return;
+    }
+    cjson_impl_sink_write_slow(this, &c, 1);
+}
+
+#endif //CJSON_CJSON_SINK_H
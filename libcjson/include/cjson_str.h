@@ -17,17 +17,24 @@
 
 
 typedef struct CJsonAllocator CJsonAllocator;
+typedef struct CJsonSink CJsonSink;
 
 typedef struct CJsonStr {
     char* _data;
     size_t _size;
 
     struct CJsonAllocator* _allocator;
+    // Views borrow their bytes and own none of them.
+    bool _is_view;
 } CJsonStr;
 
 CJsonStr* cjson_str_new_from_raw(const char* cstr, CJsonAllocator* allocator);
+CJsonStr* cjson_str_new_from_bytes(const char* data, size_t size, CJsonAllocator* allocator);
 CJsonStr* cjson_str_new_of_size(size_t size, char c, CJsonAllocator* allocator);
 CJsonStr* cjson_str_new(CJsonAllocator* allocator);
+// String borrowing `size` bytes at `data`, which must be followed by a NUL and outlive it.
+// Modifying a view first copies its bytes.
+CJsonStr* cjson_str_new_view(char* data, size_t size, CJsonAllocator* allocator);
 CJsonStr* cjson_str_copy(const CJsonStr* this);
 char* cjson_raw_str_copy(const char* this, CJsonAllocator* allocator);
 void cjson_str_free(CJsonStr* this);
@@ -59,6 +66,11 @@ CJsonStr* cjson_str_concat(const CJsonStr* s1, const CJsonStr* s2);
 void cjson_str_fmt(CJsonStringStream* stream, const CJsonStr* this);
 void cjson_raw_str_fmt(CJsonStringStream* stream, const char* str);
 
+// Writes the string quoted, escaping quotes, backslashes and control characters.
+void cjson_str_write(CJsonSink* sink, const CJsonStr* this);
+void cjson_raw_str_write(CJsonSink* sink, const char* str);
+void cjson_impl_str_write_bytes(CJsonSink* sink, const char* data, size_t size);
+
 #define CJSON_STR_A(s, allocator) (cjson_str_new_from_raw(s, allocator))
 #define CJSON_STR(s) CJSON_STR_A(s, NULL)
 
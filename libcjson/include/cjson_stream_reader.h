@@ -0,0 +1,72 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_STREAM_READER_H
+#define CJSON_CJSON_STREAM_READER_H
+
+#include "cjson_value.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+typedef struct CJsonImplStreamReader CJsonImplStreamReader;
+
+typedef enum CJsonStreamFraming {
+    // One document per line (NDJSON, JSON Lines); blank lines are skipped.
+    cjson_ndjson_framing = 0,
+    // RFC 7464 JSON text sequences: every document is preceded by a RS (0x1E) byte.
+    cjson_json_seq_framing,
+    // Documents back to back, as in `{...}{...}`, with optional whitespace in between.
+    cjson_concatenated_framing
+} CJsonStreamFraming;
+
+typedef struct CJsonStreamRecord {
+    // Position of the record in the stream, counting from 0.
+    size_t index;
+    const char* data;
+    size_t size;
+    // NULL when the record is not a valid document.
+    CJsonValue* value;
+} CJsonStreamRecord;
+
+// The record and its value only live until the handler returns: the value is allocated in the
+// arena of the thread which parsed it, and the arena is reused for the records that follow.
+// Returning false stops the reader.
+typedef bool (*CJsonStreamHandler)(void* context, const CJsonStreamRecord* record);
+
+typedef struct CJsonStreamReaderOptions {
+    CJsonStreamFraming framing;
+    // Parsing threads, 0 for one per online CPU. With a single thread, records are parsed by the
+    // thread feeding the reader.
+    size_t threads;
+    // Hands records over in stream order, one at a time. Otherwise each thread hands its records
+    // over as soon as they are parsed, and the handler is called concurrently.
+    bool ordered;
+    // Deepest nesting of arrays and objects accepted in a record, 0 for no limit.
+    size_t max_depth;
+} CJsonStreamReaderOptions;
+
+// Splits a stream of documents into records and parses them on a pool of threads. The stream is
+// fed in chunks of any size; a record split across chunks is carried over to the next feed.
+// Every feed returns once all the records it completed have been handed over.
+typedef struct CJsonStreamReader {
+    CJsonImplStreamReader* _impl;
+} CJsonStreamReader;
+
+CJsonStreamReaderOptions cjson_stream_reader_options_default();
+
+// NULL when the reader or the arenas of its workers cannot be allocated.
+CJsonStreamReader* cjson_stream_reader_new(const CJsonStreamReaderOptions* options, CJsonStreamHandler handler, void* context);
+void cjson_stream_reader_free(CJsonStreamReader* this);
+
+// Both return false once the handler asked to stop.
+bool cjson_stream_reader_feed(CJsonStreamReader* this, const char* chunk, size_t size);
+// Hands over the record left at the end of the stream, if any.
+bool cjson_stream_reader_finish(CJsonStreamReader* this);
+
+// Number of records split from the stream so far.
+size_t cjson_stream_reader_count(const CJsonStreamReader* this);
+
+#endif //CJSON_CJSON_STREAM_READER_H
@@ -0,0 +1,111 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_TOKENIZER_H
+#define CJSON_CJSON_TOKENIZER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifndef CJSON_TOKENIZER_NUMBER_BUFFER_SIZE
+#define CJSON_TOKENIZER_NUMBER_BUFFER_SIZE 64
+#endif
+
+// Deepest nesting a CJsonSyntaxStack can hold.
+#ifndef CJSON_SYNTAX_MAX_DEPTH
+#define CJSON_SYNTAX_MAX_DEPTH 1024
+#endif
+
+// Tokens and grammar shared by the readers working on spans of input that are not
+// NUL terminated: the push parser and the event reader.
+
+typedef enum CJsonCharClass {
+    cjson_other_char = 0,
+    cjson_blank_char,
+    cjson_digit_char,
+    cjson_minus_char,
+    // Letters, '+' and '.', which only appear within numbers and literals.
+    cjson_scalar_char,
+    cjson_quote_char,
+    cjson_left_brace_char,
+    cjson_right_brace_char,
+    cjson_left_bracket_char,
+    cjson_right_bracket_char,
+    cjson_comma_char,
+    cjson_colon_char
+} CJsonCharClass;
+
+extern const unsigned char CJSON_CHAR_CLASS_MAP[256];
+
+static inline CJsonCharClass cjson_char_class(char c) {
+    return (CJsonCharClass) CJSON_CHAR_CLASS_MAP[(unsigned char) c];
+}
+
+typedef enum CJsonScalarKind {
+    cjson_invalid_scalar = 0,
+    cjson_null_scalar,
+    cjson_true_scalar,
+    cjson_false_scalar,
+    cjson_number_scalar
+} CJsonScalarKind;
+
+// What a reader expects to read next.
+typedef enum CJsonSyntaxState {
+    cjson_syntax_value_state = 0,
+    cjson_syntax_first_value_state,
+    cjson_syntax_first_key_state,
+    cjson_syntax_key_state,
+    cjson_syntax_colon_state,
+    cjson_syntax_separator_state,
+    cjson_syntax_done_state,
+    cjson_syntax_error_state
+} CJsonSyntaxState;
+
+// Containers open around what a reader or writer is at, one bit each, set for objects.
+typedef struct CJsonSyntaxStack {
+    uint64_t bits[(CJSON_SYNTAX_MAX_DEPTH + 63) / 64];
+    size_t depth;
+} CJsonSyntaxStack;
+
+bool cjson_tokenizer_is_blank(char c);
+const char* cjson_tokenizer_skip_blank(const char* cursor, const char* end);
+
+// End of the number or literal starting at `cursor`.
+const char* cjson_tokenizer_scalar_end(const char* cursor, const char* end);
+CJsonScalarKind cjson_tokenizer_classify_scalar(const char* data, size_t size);
+
+// `data` must hold a valid number, which is parsed from a NUL terminated copy: on the stack, or on
+// the heap for numbers of CJSON_TOKENIZER_NUMBER_BUFFER_SIZE bytes or more. NaN when out of memory.
+double cjson_tokenizer_number_value(const char* data, size_t size);
+
+// Whether a span ending inside a string ends on a backslash which escapes the next byte.
+bool cjson_tokenizer_ends_with_escape(const char* cursor, const char* end);
+
+// Whether the 4 bytes at `data` are hexadecimal digits, whose value is then stored in `value`.
+bool cjson_impl_tokenizer_hex4(const char* data, unsigned* value);
+
+bool cjson_tokenizer_has_escape(const char* data, size_t size);
+// Decodes the escape sequences of the string content `data` into `out`, `\u` sequences as UTF-8.
+// The result is never longer than the input, so `out` may be `data` itself. Returns false on a
+// malformed escape sequence.
+bool cjson_tokenizer_unescape(const char* data, size_t size, char* out, size_t* out_size);
+
+bool cjson_syntax_expects_value(CJsonSyntaxState state);
+bool cjson_syntax_expects_key(CJsonSyntaxState state);
+bool cjson_syntax_can_close(CJsonSyntaxState state, bool is_object);
+// State once a value is complete, `depth` counting the containers still open.
+CJsonSyntaxState cjson_syntax_after_value(size_t depth);
+CJsonSyntaxState cjson_syntax_after_open(bool is_object);
+CJsonSyntaxState cjson_syntax_after_comma(bool in_object);
+
+void cjson_syntax_stack_init(CJsonSyntaxStack* this);
+// Returns false, leaving the stack as it is, when `max_depth` containers are open already.
+// `max_depth` is at most CJSON_SYNTAX_MAX_DEPTH.
+bool cjson_syntax_stack_push(CJsonSyntaxStack* this, bool is_object, size_t max_depth);
+void cjson_syntax_stack_pop(CJsonSyntaxStack* this);
+// False when no container is open.
+bool cjson_syntax_stack_top_is_object(const CJsonSyntaxStack* this);
+
+#endif //CJSON_CJSON_TOKENIZER_H
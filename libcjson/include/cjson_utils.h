@@ -10,6 +10,7 @@
 #define cjson_utils_h
 
 #include <stdarg.h>
+#include <stdlib.h>
 
 #define CJSON_UNUSED __attribute__((unused))
 
@@ -23,4 +24,7 @@
 
 int cjson_mod(int x, int n);
 
+// Threads to start for a `threads` option, where 0 stands for one per online CPU.
+size_t cjson_thread_count(size_t threads);
+
 #endif /* cjson_utils_h */
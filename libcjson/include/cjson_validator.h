@@ -0,0 +1,23 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#ifndef CJSON_CJSON_VALIDATOR_H
+#define CJSON_CJSON_VALIDATOR_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifndef CJSON_VALIDATOR_MAX_DEPTH
+#define CJSON_VALIDATOR_MAX_DEPTH 1024
+#endif
+
+
+// Checks that `data` holds a single JSON text, without building any value nor allocating. On top
+// of the grammar checked by the readers, strings must be valid UTF-8 free of control characters
+// and their escape sequences well formed. Nesting deeper than CJSON_VALIDATOR_MAX_DEPTH is
+// rejected. On failure, `error_offset`, when not NULL, receives the offset of the offending byte,
+// or `size` when the input ends too early.
+bool cjson_validate(const char* data, size_t size, size_t* error_offset);
+
+#endif //CJSON_CJSON_VALIDATOR_H
@@ -12,6 +12,8 @@
 #include "cjson_utils.h"
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 
 typedef struct CJsonObject CJsonObject;
@@ -36,8 +38,12 @@ typedef struct CJsonValue {
         struct CJsonStr* _str;
         bool _bool;
         double _number;
+        // Input bytes of a lazy number or string, decoded on first access.
+        const char* _lazy;
     };
     CJsonValueType _type;
+    // Size of the bytes at `_lazy`, 0 once the value is decoded.
+    uint32_t _lazy_size;
     CJsonAllocator* _allocator;
 } CJsonValue;
 
@@ -48,6 +54,12 @@ CJsonValue* cjson_value_new_as_array(CJsonArray* array, CJsonAllocator* allocato
 CJsonValue* cjson_value_new_as_str(CJsonStr* str, CJsonAllocator* allocator);
 CJsonValue* cjson_value_new_as_bool(bool val, CJsonAllocator* allocator);
 CJsonValue* cjson_value_new_as_number(double val, CJsonAllocator* allocator);
+// Lazy values keep the bytes of a JSON number, or of the content of a JSON string free of escape
+// sequences, and are only decoded in place by cjson_value_get_number or cjson_value_get_str.
+// `data` must outlive the value. Functions taking a const value never decode it, so a lazy tree
+// may be read, compared and written from several threads, but not through the getters.
+CJsonValue* cjson_value_new_as_lazy_number(const char* data, size_t size, CJsonAllocator* allocator);
+CJsonValue* cjson_value_new_as_lazy_str(const char* data, size_t size, CJsonAllocator* allocator);
 CJsonValue* cjson_value_copy(const CJsonValue* this);
 void cjson_value_free(CJsonValue* this);
 void cjson_value_reset(CJsonValue* this);
@@ -80,6 +92,29 @@ void cjson_number_fmt(CJsonStringStream* stream, const double* val);
 void cjson_value_fmt(CJsonStringStream* stream, const CJsonValue* this);
 void cjson_null_fmt(CJsonStringStream* stream);
 
+// Content of a number or string value, lazy or not, read without decoding the value in place.
+double cjson_impl_value_number(const CJsonValue* this);
+void cjson_impl_value_str_bytes(const CJsonValue* this, const char** data, size_t* size);
+
+#ifndef CJSON_VALUE_STACK_INLINE_SIZE
+#define CJSON_VALUE_STACK_INLINE_SIZE 32
+#endif
+
+// Containers waiting to be freed. Trees are freed without recursing, so that their depth is only
+// bounded by memory: the stack starts inline and moves to the heap when it outgrows it.
+typedef struct CJsonImplValueStack {
+    CJsonValue** _data;
+    size_t _size;
+    size_t _capacity;
+    CJsonValue* _inline[CJSON_VALUE_STACK_INLINE_SIZE];
+} CJsonImplValueStack;
+
+void cjson_impl_value_stack_init(CJsonImplValueStack* this);
+// Frees `value` at once when it holds no container, otherwise leaves it to `pending`.
+void cjson_impl_value_free_deferred(CJsonValue* value, CJsonImplValueStack* pending);
+// Frees every value left on the stack, along with those they leave in turn, and the stack itself.
+void cjson_impl_value_stack_drain(CJsonImplValueStack* this);
+
 #define CJSON_NULL_V_A(allocator) (cjson_value_new_as_null(allocator))
 #define CJSON_NULL_V CJSON_NULL_V_A(NULL)
 #define CJSON_BOOL_V_A(x, allocator) (cjson_value_new_as_bool(x, allocator))
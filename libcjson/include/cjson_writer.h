@@ -9,12 +9,119 @@
 #ifndef cjson_writer_h
 #define cjson_writer_h
 
+#include "cjson_sink.h"
+#include "cjson_tokenizer.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+// Longest number written, sign, digits, exponent and terminating NUL included.
+#define CJSON_NUMBER_MAX_LENGTH 32
+
+#ifndef CJSON_PRINT_BUFFER_SIZE
+#define CJSON_PRINT_BUFFER_SIZE 4096
+#endif
+
+#ifndef CJSON_TO_STR_INITIAL_SIZE
+#define CJSON_TO_STR_INITIAL_SIZE 256
+#endif
+
+#ifndef CJSON_WRITER_MAX_DEPTH
+#define CJSON_WRITER_MAX_DEPTH 1024
+#endif
+
 
 typedef struct CJsonValue CJsonValue;
+typedef struct CJsonArray CJsonArray;
+typedef struct CJsonObject CJsonObject;
 typedef struct CJsonAllocator CJsonAllocator;
 
+typedef enum CJsonWriteStyle {
+    // No whitespace at all.
+    cjson_compact_write_style = 0,
+    // One element or member per line, indented by nesting depth, with a space after colons.
+    cjson_pretty_write_style
+} CJsonWriteStyle;
+
+typedef struct CJsonWriteOptions {
+    CJsonWriteStyle style;
+    // Spaces per nesting level in the pretty style.
+    size_t indent;
+} CJsonWriteOptions;
+
+CJsonWriteOptions cjson_write_options_default();
+
+// Serializes `value` into `sink` and flushes it, so that the output never needs to be held whole.
+// False when the sink failed.
+bool cjson_write(const CJsonValue* value, CJsonSink* sink);
+bool cjson_write_with_options(const CJsonValue* value, const CJsonWriteOptions* options, CJsonSink* sink);
+// Serializes `value` into `sink`, leaving the output buffered.
+void cjson_write_value(CJsonSink* sink, const CJsonValue* value, const CJsonWriteOptions* options);
+
+// Exact length of the output of cjson_write, computed without allocating.
+size_t cjson_serialized_size(const CJsonValue* value, const CJsonWriteOptions* options);
+// Writes `value` into the `capacity` bytes at `buffer`, with no terminating NUL and no allocation.
+// False when the output was truncated to fit. `size`, if not NULL, receives the full length of the
+// output, which is also what a truncated write needed.
+bool cjson_write_to_buffer(const CJsonValue* value, char* buffer, size_t capacity, const CJsonWriteOptions* options, size_t* size);
+
+// Writes to the standard output through a buffer on the stack. `allocator` is not used any more.
 void cjson_print(const CJsonValue* value, CJsonAllocator* allocator);
 
+// NUL terminated output from `allocator`, written in a single pass into a buffer which grows as
+// needed and is shrunk to fit. NULL when out of memory.
 char* cjson_to_str(const CJsonValue* value, CJsonAllocator* allocator);
+char* cjson_to_str_with_options(const CJsonValue* value, const CJsonWriteOptions* options, CJsonAllocator* allocator);
+
+// Writes a document piece by piece straight into a sink, without building a value tree, so that
+// nothing is allocated. Nesting is checked as it goes: a call out of place fails the writer, which
+// then ignores every call after it. Separators and indentation follow the write options.
+typedef struct CJsonWriter {
+    CJsonSink* _sink;
+    CJsonWriteOptions _options;
+    CJsonSyntaxState _state;
+    CJsonSyntaxStack _containers;
+} CJsonWriter;
+
+// Sets up a writer in storage of the caller's. NULL options select the defaults.
+void cjson_writer_init(CJsonWriter* this, CJsonSink* sink, const CJsonWriteOptions* options);
+
+// All return false once the writer failed.
+bool cjson_writer_begin_object(CJsonWriter* this);
+bool cjson_writer_end_object(CJsonWriter* this);
+bool cjson_writer_begin_array(CJsonWriter* this);
+bool cjson_writer_end_array(CJsonWriter* this);
+// Key of the object member whose value comes next.
+bool cjson_writer_key(CJsonWriter* this, const char* key);
+bool cjson_writer_key_bytes(CJsonWriter* this, const char* key, size_t size);
+bool cjson_writer_string(CJsonWriter* this, const char* str);
+bool cjson_writer_string_bytes(CJsonWriter* this, const char* data, size_t size);
+bool cjson_writer_number(CJsonWriter* this, double value);
+bool cjson_writer_bool(CJsonWriter* this, bool value);
+bool cjson_writer_null(CJsonWriter* this);
+// Writes a whole value tree where a value is expected.
+bool cjson_writer_value(CJsonWriter* this, const CJsonValue* value);
+
+// Flushes the sink. False unless a whole document was written and handed over.
+bool cjson_writer_finish(CJsonWriter* this);
+// Set by a call out of place, or by a failure of the sink.
+bool cjson_writer_failed(const CJsonWriter* this);
+
+// Numbers are written as integers when they are, otherwise with the fewest significant digits
+// which read back as the same double. NaN and infinities, which JSON lacks, are written as null.
+void cjson_number_write(CJsonSink* sink, double value);
+// Formats `value` into the CJSON_NUMBER_MAX_LENGTH bytes at `out`, returning its length.
+size_t cjson_impl_number_format(char* out, double value);
+
+// Separator ahead of an element or member of a container at `depth`: a comma unless `first`,
+// then in the pretty style a line break and the indentation of the element.
+void cjson_impl_write_separator(CJsonSink* sink, const CJsonWriteOptions* options, size_t depth, bool first);
+// Line break and indentation ahead of the closing bracket of a non-empty container, pretty style only.
+void cjson_impl_write_closing(CJsonSink* sink, const CJsonWriteOptions* options, size_t depth);
+void cjson_impl_write_key_separator(CJsonSink* sink, const CJsonWriteOptions* options);
+
+void cjson_impl_write_value(CJsonSink* sink, const CJsonValue* value, const CJsonWriteOptions* options, size_t depth);
+void cjson_impl_write_array(CJsonSink* sink, const CJsonArray* array, const CJsonWriteOptions* options, size_t depth);
+void cjson_impl_write_object(CJsonSink* sink, const CJsonObject* object, const CJsonWriteOptions* options, size_t depth);
 
 #endif /* cjson_writer_h */
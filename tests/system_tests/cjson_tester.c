@@ -1,6 +1,4 @@
 #include <stdio.h>
-#include <sys/mman.h>
-#include <fcntl.h>
 #include <unistd.h>
 #include <time.h>
 
@@ -19,23 +17,12 @@ int main(int argc, char** argv) {
         return 2;
     }
 
-    const int fd = open(path, O_RDONLY);
-    if(fd < 0) {
-        fprintf(stderr, "error: could not open '%s'\n", path);
-        return 3;
-    }
-
-    const off_t file_len = lseek(fd, 0, SEEK_END);
-    char* data = mmap(0, file_len, PROT_READ, MAP_PRIVATE, fd, 0);
-
-    CJsonAllocator* allocator = cjson_linear_allocator_new(16 * 1024 * 1024);
-
-    CJsonValue* value = NULL;
+    CJsonDocument* document = NULL;
     {
         clock_t t = clock();
-        value = cjson_read(data, allocator);
+        document = cjson_document_read_file(path, NULL);
         t = clock() - t;
-        if(value == NULL) {
+        if(document == NULL) {
             fprintf(stderr, "error: could not parse json\n");
             return 4;
         }
@@ -43,6 +30,9 @@ int main(int argc, char** argv) {
         printf("parse_time=%fs\n", time_taken);
     }
 
+    CJsonValue* value = cjson_document_root(document);
+    CJsonAllocator* allocator = cjson_document_allocator(document);
+
     {
         clock_t t = clock();
         char* result = cjson_to_str(value, allocator);
@@ -58,12 +48,11 @@ int main(int argc, char** argv) {
 
     {
         clock_t t = clock();
-        cjson_value_free(value);
+        cjson_document_free(document);
         t = clock() - t;
         const double time_taken = ((double)t) / CLOCKS_PER_SEC;
         printf("cleanup_time=%fs\n", time_taken);
     }
 
-    cjson_linear_allocator_free(allocator);
-    return close(fd);
+    return 0;
 }
@@ -10,9 +10,21 @@
 
 void allocator_case_setup(Suite*);
 void array_case_setup(Suite*);
+void array_stream_case_setup(Suite*);
+void compressed_reader_case_setup(Suite*);
+void cursor_case_setup(Suite*);
+void document_case_setup(Suite*);
+void events_case_setup(Suite*);
+void file_reader_case_setup(Suite*);
 void object_case_setup(Suite*);
+void parser_case_setup(Suite*);
+void projection_case_setup(Suite*);
 void reader_case_setup(Suite*);
+void scanner_case_setup(Suite*);
 void str_case_setup(Suite*);
+void stream_reader_case_setup(Suite*);
 void string_stream_case_setup(Suite*);
+void validator_case_setup(Suite*);
+void writer_case_setup(Suite*);
 
 #endif //CJSON_CASES_H
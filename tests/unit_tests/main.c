@@ -47,11 +47,23 @@ size_t read_settings(Settings* settings, int argc, char** argv) {
 void register_cases(Suite* suite)
 {
     array_case_setup(suite);
+    array_stream_case_setup(suite);
     allocator_case_setup(suite);
+    compressed_reader_case_setup(suite);
+    cursor_case_setup(suite);
+    document_case_setup(suite);
+    events_case_setup(suite);
+    file_reader_case_setup(suite);
     object_case_setup(suite);
+    parser_case_setup(suite);
+    projection_case_setup(suite);
     reader_case_setup(suite);
+    scanner_case_setup(suite);
     str_case_setup(suite);
+    stream_reader_case_setup(suite);
     string_stream_case_setup(suite);
+    validator_case_setup(suite);
+    writer_case_setup(suite);
 }
 
 int main(int argc, char** argv) {
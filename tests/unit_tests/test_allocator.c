@@ -3,10 +3,16 @@
 //
 
 #include "cases.h"
+#include "helpers.h"
 
 #include <cjson_allocator.h>
+#include <cjson_allocator_stats.h>
+#include <cjson_reader.h>
+#include <cjson_value.h>
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 
 typedef struct TestAllocatorContext {
@@ -106,9 +112,143 @@ START_TEST(test) {
     ck_assert_ptr_eq(ctx->last_dealloc_call_address_arg, ptr2);
 }
 
+START_TEST(test_allocator_init) {
+    TestAllocatorContext ctx;
+    reset_test_allocator_context(&ctx);
+    CJsonAllocator allocator = CJSON_ALLOCATOR_INIT(test_allocator_alloc, test_allocator_realloc, test_allocator_dealloc, &ctx);
+    ck_assert(!cjson_allocator_has_bulk_free(&allocator));
+    // Without alloc_kind, allocations of any kind go through alloc.
+    ck_assert_ptr_nonnull(cjson_alloc_kind(&allocator, 12, cjson_value_allocation));
+    ck_assert_int_eq(ctx.alloc_calls, 1);
+    ck_assert_int_eq(ctx.last_alloc_call_size_arg, 12);
+}
+
+START_TEST(test_traits) {
+    ck_assert_not(cjson_allocator_has_bulk_free(NULL));
+    ck_assert_not(cjson_allocator_has_bulk_free(cjson_allocator_get_default()));
+    ck_assert_not(cjson_allocator_has_bulk_free(get_test_allocator(true)));
+
+    CJsonAllocator* allocator = cjson_linear_allocator_new(64);
+    ck_assert(cjson_allocator_has_bulk_free(allocator));
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_linear_allocator_exhaustion) {
+    CJsonAllocator* allocator = cjson_linear_allocator_new(256);
+    ck_assert_ptr_nonnull(cjson_alloc(allocator, 100));
+    ck_assert_ptr_nonnull(cjson_alloc(allocator, 100));
+    ck_assert_ptr_null(cjson_alloc(allocator, 100));
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_linear_allocator_alignment) {
+    CJsonAllocator* allocator = cjson_linear_allocator_new(1024);
+    char* ptr1 = (char*) cjson_alloc(allocator, 3);
+    char* ptr2 = (char*) cjson_alloc(allocator, 5);
+    ck_assert_int_eq((size_t) ptr1 % CJSON_LINEAR_ALLOCATOR_ALIGNMENT, 0);
+    ck_assert_int_eq((size_t) ptr2 % CJSON_LINEAR_ALLOCATOR_ALIGNMENT, 0);
+
+    const uintptr_t address2 = (uintptr_t) ptr2;
+    char* ptr3 = (char*) cjson_realloc(allocator, ptr2, 100);
+    ck_assert_uint_eq((uintptr_t) ptr3, address2);
+    ptr1 = (char*) cjson_realloc(allocator, ptr1, 100);
+    ck_assert_ptr_ne(ptr1, ptr3);
+    ck_assert_int_eq((size_t) ptr1 % CJSON_LINEAR_ALLOCATOR_ALIGNMENT, 0);
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_mapped_linear_allocator) {
+    const size_t step = 64 * 1024;
+    CJsonAllocator* allocator = cjson_mapped_linear_allocator_new(1024 * 1024, step, cjson_mapped_arena_no_flags);
+    ck_assert_ptr_nonnull(allocator);
+    ck_assert(cjson_allocator_has_bulk_free(allocator));
+
+    char* first = (char*) cjson_alloc(allocator, step / 2);
+    ck_assert_ptr_nonnull(first);
+    first[0] = 'a';
+    first[step / 2 - 1] = 'b';
+    char* second = (char*) cjson_alloc(allocator, step);
+    ck_assert_ptr_nonnull(second);
+    second[step - 1] = 'c';
+    ck_assert_ptr_null(cjson_alloc(allocator, 2 * 1024 * 1024));
+
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_mapped_linear_allocator_huge_pages) {
+    const unsigned int flags = cjson_mapped_arena_hugetlb | cjson_mapped_arena_populate;
+    CJsonAllocator* allocator = cjson_mapped_linear_allocator_new(8 * 1024 * 1024, 0, flags);
+    ck_assert_ptr_nonnull(allocator);
+
+    char* data = (char*) cjson_alloc(allocator, 3 * 1024 * 1024);
+    ck_assert_ptr_nonnull(data);
+    memset(data, 42, 3 * 1024 * 1024);
+
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_stats) {
+    CJsonAllocator* allocator = cjson_stats_allocator_new(NULL);
+    ck_assert_ptr_nonnull(allocator);
+    ck_assert_ptr_null(cjson_allocator_stats(cjson_allocator_get_default()));
+    const CJsonAllocatorStats* stats = cjson_allocator_stats(allocator);
+    ck_assert_ptr_nonnull(stats);
+
+    void* ptr = cjson_alloc_kind(allocator, 10, cjson_key_allocation);
+    ck_assert_ptr_nonnull(ptr);
+    ck_assert_int_eq(stats->total.allocs, 1);
+    ck_assert_int_eq(stats->total.live_bytes, 10);
+    ck_assert_int_eq(stats->by_kind[cjson_key_allocation].allocs, 1);
+
+    ptr = cjson_realloc(allocator, ptr, 30);
+    ck_assert_ptr_nonnull(ptr);
+    ck_assert_int_eq(stats->total.reallocs, 1);
+    ck_assert_int_eq(stats->by_kind[cjson_key_allocation].live_bytes, 30);
+    ck_assert_int_eq(stats->peak_bytes, 30);
+
+    cjson_dealloc(allocator, ptr);
+    ck_assert_int_eq(stats->total.deallocs, 1);
+    ck_assert_int_eq(stats->total.live_bytes, 0);
+    ck_assert_int_eq(stats->by_kind[cjson_key_allocation].live_bytes, 0);
+    ck_assert_int_eq(stats->peak_bytes, 30);
+
+    cjson_allocator_stats_reset(allocator);
+    ck_assert_int_eq(stats->total.allocs, 0);
+    ck_assert_int_eq(stats->peak_bytes, 0);
+
+    cjson_stats_allocator_free(allocator);
+}
+
+START_TEST(test_stats_by_kind) {
+    CJsonAllocator* allocator = cjson_stats_allocator_new(NULL);
+    const CJsonAllocatorStats* stats = cjson_allocator_stats(allocator);
+
+    char data[] = RAW_JSON({"key": ["value", 42]});
+    CJsonValue* value = cjson_read(data, allocator);
+    ck_assert_ptr_nonnull(value);
+    ck_assert_int_eq(stats->by_kind[cjson_value_allocation].allocs, 4);
+    ck_assert_int_eq(stats->by_kind[cjson_object_node_allocation].allocs, 2);
+    ck_assert_int_eq(stats->by_kind[cjson_array_allocation].allocs, 1);
+    ck_assert_int_eq(stats->by_kind[cjson_reader_allocation].live_bytes, 0);
+
+    cjson_value_free(value);
+    ck_assert_int_eq(stats->total.live_bytes, 0);
+    ck_assert_int_eq(stats->total.allocs, stats->total.deallocs);
+
+    cjson_stats_allocator_free(allocator);
+}
+
 void allocator_case_setup(Suite* suite) {
     TCase* allocator_case = tcase_create("allocator");
     suite_add_tcase(suite, allocator_case);
 
     tcase_add_test(allocator_case, test);
+    tcase_add_test(allocator_case, test_allocator_init);
+    tcase_add_test(allocator_case, test_traits);
+    tcase_add_test(allocator_case, test_linear_allocator_exhaustion);
+    tcase_add_test(allocator_case, test_linear_allocator_alignment);
+    tcase_add_test(allocator_case, test_mapped_linear_allocator);
+    tcase_add_test(allocator_case, test_mapped_linear_allocator_huge_pages);
+    tcase_add_test(allocator_case, test_stats);
+    tcase_add_test(allocator_case, test_stats_by_kind);
 }
@@ -0,0 +1,94 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_array_stream.h>
+#include <cjson_value.h>
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_str.h>
+
+#include <string.h>
+#include <unistd.h>
+
+
+const char k_elements[] = RAW_JSON([
+    {"id": 1, "tags": ["a", "]"]},
+    "a string with a , and a ]",
+    12345,
+    [[], {}],
+    null
+]);
+
+void check_elements(CJsonArrayStream* stream) {
+    CJsonValue* expected = CJSON_ARRAY_V(
+        CJSON_OBJECT_V("id", CJSON_NUMBER_V(1), "tags", CJSON_ARRAY_V(CJSON_STR_V("a"), CJSON_STR_V("]"))),
+        CJSON_STR_V("a string with a , and a ]"),
+        CJSON_NUMBER_V(12345),
+        CJSON_ARRAY_V(CJSON_EMPTY_ARRAY_V, CJSON_EMPTY_OBJECT_V),
+        CJSON_NULL_V
+    );
+    CJsonArray* expected_elements = cjson_value_get_array(expected);
+    size_t count = 0;
+    CJsonValue* value = NULL;
+    while(cjson_array_stream_next(stream, &value)) {
+        ck_assert_uint_lt(count, cjson_array_size(expected_elements));
+        ck_assert(cjson_value_equals(value, cjson_array_at(expected_elements, count)));
+        ++count;
+    }
+    ck_assert(!cjson_array_stream_failed(stream));
+    ck_assert_uint_eq(count, cjson_array_size(expected_elements));
+    ck_assert(!cjson_array_stream_next(stream, &value));
+    cjson_value_free(expected);
+}
+
+START_TEST(test_stream_buffer) {
+    CJsonArrayStream* stream = cjson_array_stream_open_buffer(k_elements, strlen(k_elements), NULL);
+    check_elements(stream);
+    cjson_array_stream_close(stream);
+
+    const char empty[] = " [ ]\n";
+    CJsonValue* value = NULL;
+    stream = cjson_array_stream_open_buffer(empty, strlen(empty), NULL);
+    ck_assert(!cjson_array_stream_next(stream, &value));
+    ck_assert(!cjson_array_stream_failed(stream));
+    cjson_array_stream_close(stream);
+}
+
+START_TEST(test_stream_fd) {
+    // A window smaller than most elements makes them span several reads.
+    CJsonArrayStreamOptions options = cjson_array_stream_options_default();
+    options.window_size = 4;
+    int pipe_fds[2];
+    ck_assert_int_eq(pipe(pipe_fds), 0);
+    ck_assert_int_eq(write(pipe_fds[1], k_elements, strlen(k_elements)), strlen(k_elements));
+    close(pipe_fds[1]);
+
+    CJsonArrayStream* stream = cjson_array_stream_open_fd(pipe_fds[0], &options);
+    check_elements(stream);
+    cjson_array_stream_close(stream);
+    close(pipe_fds[0]);
+}
+
+START_TEST(test_stream_bad_input) {
+    const char* inputs[] = {"{\"a\": 1}", "[1 2]", "[1, 2", "[1, 2] 3", "[1, {\"a\": }]", "[1,]", ""};
+    for(size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        CJsonArrayStream* stream = cjson_array_stream_open_buffer(inputs[i], strlen(inputs[i]), NULL);
+        CJsonValue* value = NULL;
+        while(cjson_array_stream_next(stream, &value)) {}
+        ck_assert(cjson_array_stream_failed(stream));
+        cjson_array_stream_close(stream);
+    }
+}
+
+void array_stream_case_setup(Suite* suite) {
+    TCase* array_stream_case = tcase_create("array_stream");
+    suite_add_tcase(suite, array_stream_case);
+
+    tcase_add_test(array_stream_case, test_stream_buffer);
+    tcase_add_test(array_stream_case, test_stream_fd);
+    tcase_add_test(array_stream_case, test_stream_bad_input);
+}
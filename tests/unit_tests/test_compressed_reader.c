@@ -0,0 +1,163 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#define _GNU_SOURCE
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_compressed_reader.h>
+#include <cjson_reader.h>
+#include <cjson_value.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef CJSON_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#define DOCUMENT_CAPACITY (1 << 16)
+
+
+// Array of objects large enough to span many blocks.
+size_t make_compressed_document(char* document) {
+    size_t size = (size_t) sprintf(document, "[");
+    for(int i = 0; i < 500; ++i) {
+        size += (size_t) sprintf(document + size, "%s{\"id\": %d, \"name\": \"item \\u00e9 %d\", \"ok\": %s}", i == 0 ? "" : ", ", i, i * 7, i % 2 ? "true" : "false");
+    }
+    size += (size_t) sprintf(document + size, "]");
+    return size;
+}
+
+void check_compressed_read(const char* input, size_t size, const char* document) {
+    CJsonValue* expected = cjson_read((char*) document, NULL);
+    CJsonCompressedReadOptions options = cjson_compressed_read_options_default();
+    // Blocks this small split most tokens across feeds.
+    options.block_size = 7;
+    options.block_count = 3;
+    for(int threaded = 0; threaded < 2; ++threaded) {
+        options.threaded = threaded;
+        CJsonValue* value = cjson_read_compressed(input, size, &options, NULL);
+        ck_assert_ptr_nonnull(value);
+        ck_assert(cjson_value_equals(value, expected));
+        cjson_value_free(value);
+    }
+    cjson_value_free(expected);
+}
+
+START_TEST(test_read_uncompressed) {
+    char* document = malloc(DOCUMENT_CAPACITY);
+    const size_t size = make_compressed_document(document);
+    check_compressed_read(document, size, document);
+
+    int pipe_fds[2];
+    ck_assert_int_eq(pipe(pipe_fds), 0);
+    ck_assert_int_eq(write(pipe_fds[1], "{\"a\": [1, 2]}", 13), 13);
+    close(pipe_fds[1]);
+    CJsonValue* value = cjson_read_compressed_fd(pipe_fds[0], NULL, NULL);
+    close(pipe_fds[0]);
+    CJsonValue* expected = cjson_read("{\"a\": [1, 2]}", NULL);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(expected);
+    cjson_value_free(value);
+
+    ck_assert_ptr_null(cjson_read_compressed("[1, 2", 5, NULL, NULL));
+
+    // Numbers starting like a zlib header are read as they are.
+    const char* numbers[] = {"80", "800", " 80"};
+    for(size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+        value = cjson_read_compressed(numbers[i], strlen(numbers[i]), NULL, NULL);
+        ck_assert_ptr_nonnull(value);
+        ck_assert(*CJSON_AS_NUMBER(value) == strtod(numbers[i], NULL));
+        cjson_value_free(value);
+    }
+    free(document);
+}
+
+#ifdef CJSON_ENABLE_ZLIB
+size_t gzip_compress(const char* data, size_t size, char* out, size_t capacity) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    // 16 asks for a gzip header.
+    ck_assert_int_eq(deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY), Z_OK);
+    stream.next_in = (Bytef*) data;
+    stream.avail_in = (uInt) size;
+    stream.next_out = (Bytef*) out;
+    stream.avail_out = (uInt) capacity;
+    ck_assert_int_eq(deflate(&stream, Z_FINISH), Z_STREAM_END);
+    const size_t compressed_size = stream.total_out;
+    deflateEnd(&stream);
+    return compressed_size;
+}
+
+START_TEST(test_read_gzip) {
+    char* document = malloc(DOCUMENT_CAPACITY);
+    char* compressed = malloc(DOCUMENT_CAPACITY);
+    const size_t size = make_compressed_document(document);
+    const size_t compressed_size = gzip_compress(document, size, compressed, DOCUMENT_CAPACITY);
+    check_compressed_read(compressed, compressed_size, document);
+
+    // Two members, as left by concatenating gzip files.
+    const size_t half = size / 2;
+    const size_t first_size = gzip_compress(document, half, compressed, DOCUMENT_CAPACITY);
+    const size_t second_size = gzip_compress(document + half, size - half, compressed + first_size, DOCUMENT_CAPACITY - first_size);
+    check_compressed_read(compressed, first_size + second_size, document);
+
+    // Read from a file.
+    char path[] = "/tmp/cjson_compressed_XXXXXX";
+    const int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, compressed, first_size + second_size), (ssize_t) (first_size + second_size));
+    ck_assert_int_eq(lseek(fd, 0, SEEK_SET), 0);
+    CJsonValue* value = cjson_read_compressed_fd(fd, NULL, NULL);
+    close(fd);
+    unlink(path);
+    CJsonValue* expected = cjson_read(document, NULL);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(expected);
+    cjson_value_free(value);
+
+    free(compressed);
+    free(document);
+}
+
+START_TEST(test_read_gzip_bad_input) {
+    char* document = malloc(DOCUMENT_CAPACITY);
+    char* compressed = malloc(DOCUMENT_CAPACITY);
+    const size_t size = make_compressed_document(document);
+    const size_t compressed_size = gzip_compress(document, size, compressed, DOCUMENT_CAPACITY);
+    CJsonCompressedReadOptions options = cjson_compressed_read_options_default();
+    options.block_size = 64;
+    for(int threaded = 0; threaded < 2; ++threaded) {
+        options.threaded = threaded;
+        // Truncated stream.
+        ck_assert_ptr_null(cjson_read_compressed(compressed, compressed_size - 10, &options, NULL));
+        // Corrupt stream.
+        compressed[compressed_size / 2] ^= 0x55;
+        ck_assert_ptr_null(cjson_read_compressed(compressed, compressed_size, &options, NULL));
+        compressed[compressed_size / 2] ^= 0x55;
+        // Malformed document.
+        const size_t bad_size = gzip_compress("[1, 2,]", 7, compressed, DOCUMENT_CAPACITY);
+        ck_assert_ptr_null(cjson_read_compressed(compressed, bad_size, &options, NULL));
+        gzip_compress(document, size, compressed, DOCUMENT_CAPACITY);
+    }
+    free(compressed);
+    free(document);
+}
+#endif
+
+void compressed_reader_case_setup(Suite* suite) {
+    TCase* compressed_reader_case = tcase_create("compressed_reader");
+    suite_add_tcase(suite, compressed_reader_case);
+
+    tcase_add_test(compressed_reader_case, test_read_uncompressed);
+#ifdef CJSON_ENABLE_ZLIB
+    tcase_add_test(compressed_reader_case, test_read_gzip);
+    tcase_add_test(compressed_reader_case, test_read_gzip_bad_input);
+#endif
+}
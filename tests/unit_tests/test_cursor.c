@@ -0,0 +1,116 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_cursor.h>
+#include <cjson_value.h>
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_str.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+
+const char k_event[] = RAW_JSON({
+    "id": "evt-1",
+    "payload": {"items": [{"k": "}"}, [1, [2, "]"]], "x\"y"], "flag": true},
+    "user": {"name": "ada", "age": 36, "tags": ["a", "b", "c"], "manager": null}
+});
+
+START_TEST(test_find_field) {
+    CJsonCursor cursor;
+    cjson_cursor_init(&cursor, k_event, strlen(k_event));
+    ck_assert(cjson_cursor_find_field(&cursor, "user"));
+    ck_assert(cjson_cursor_find_field(&cursor, "age"));
+
+    double age = 0;
+    ck_assert(cjson_cursor_get_double(&cursor, &age));
+    ck_assert(age == 36);
+}
+
+START_TEST(test_find_missing_field) {
+    CJsonCursor cursor;
+    cjson_cursor_init(&cursor, k_event, strlen(k_event));
+    ck_assert(!cjson_cursor_find_field(&cursor, "missing"));
+    ck_assert(cjson_cursor_find_field(&cursor, "payload"));
+    ck_assert(cjson_cursor_find_field(&cursor, "flag"));
+
+    bool flag = false;
+    ck_assert(cjson_cursor_get_bool(&cursor, &flag));
+    ck_assert(flag);
+}
+
+START_TEST(test_long_number_at_end) {
+    char* data = malloc(70);
+    data[0] = '1';
+    memset(data + 1, '0', 69);
+    CJsonCursor cursor;
+    cjson_cursor_init(&cursor, data, 70);
+
+    double value = 0;
+    ck_assert(cjson_cursor_get_double(&cursor, &value));
+    ck_assert(value == 1e69);
+    free(data);
+}
+
+START_TEST(test_elements) {
+    CJsonCursor cursor;
+    cjson_cursor_init(&cursor, k_event, strlen(k_event));
+    ck_assert(cjson_cursor_find_field(&cursor, "user"));
+    ck_assert(cjson_cursor_find_field(&cursor, "tags"));
+
+    char tags[8] = {0};
+    size_t count = 0;
+    for(bool has_element = cjson_cursor_first_element(&cursor); has_element; has_element = cjson_cursor_next_element(&cursor)) {
+        const char* data = NULL;
+        size_t size = 0;
+        ck_assert(cjson_cursor_get_string(&cursor, &data, &size));
+        ck_assert_uint_eq(size, 1);
+        tags[count++] = *data;
+    }
+    ck_assert_str_eq(tags, "abc");
+}
+
+START_TEST(test_type) {
+    CJsonCursor cursor;
+    CJsonValueType type;
+    cjson_cursor_init(&cursor, k_event, strlen(k_event));
+    ck_assert(cjson_cursor_type(&cursor, &type));
+    ck_assert_int_eq(type, cjson_object_value);
+    ck_assert(cjson_cursor_find_field(&cursor, "user"));
+    ck_assert(cjson_cursor_find_field(&cursor, "manager"));
+    ck_assert(cjson_cursor_type(&cursor, &type));
+    ck_assert_int_eq(type, cjson_null_value);
+    ck_assert(cjson_cursor_is_null(&cursor));
+}
+
+START_TEST(test_read_value) {
+    CJsonCursor cursor;
+    cjson_cursor_init(&cursor, k_event, strlen(k_event));
+    ck_assert(cjson_cursor_find_field(&cursor, "user"));
+    ck_assert(cjson_cursor_find_field(&cursor, "tags"));
+
+    CJsonValue* tags = cjson_cursor_read_value(&cursor, NULL);
+    CJsonValue* expected = CJSON_ARRAY_V(CJSON_STR_V("a"), CJSON_STR_V("b"), CJSON_STR_V("c"));
+    ck_assert_ptr_nonnull(tags);
+    ck_assert(cjson_value_equals(tags, expected));
+
+    cjson_value_free(tags);
+    cjson_value_free(expected);
+}
+
+void cursor_case_setup(Suite* suite) {
+    TCase* cursor_case = tcase_create("cursor");
+    suite_add_tcase(suite, cursor_case);
+
+    tcase_add_test(cursor_case, test_find_field);
+    tcase_add_test(cursor_case, test_find_missing_field);
+    tcase_add_test(cursor_case, test_long_number_at_end);
+    tcase_add_test(cursor_case, test_elements);
+    tcase_add_test(cursor_case, test_type);
+    tcase_add_test(cursor_case, test_read_value);
+}
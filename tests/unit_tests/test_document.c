@@ -0,0 +1,170 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#define _GNU_SOURCE
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_allocator.h>
+#include <cjson_allocator_stats.h>
+#include <cjson_document.h>
+#include <cjson_reader.h>
+#include <cjson_value.h>
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_str.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+START_TEST(test_new) {
+    CJsonDocument* document = cjson_document_new(1024);
+    ck_assert_ptr_nonnull(document);
+    ck_assert_ptr_null(cjson_document_root(document));
+    ck_assert(cjson_allocator_has_bulk_free(cjson_document_allocator(document)));
+
+    cjson_document_free(document);
+
+    // Only linear arenas are taken over.
+    ck_assert_ptr_null(cjson_document_new_with_arena(cjson_allocator_get_default()));
+    CJsonAllocator* arena = cjson_linear_allocator_new(1024);
+    CJsonAllocator* stats = cjson_stats_allocator_new(arena);
+    ck_assert_ptr_null(cjson_document_new_with_arena(stats));
+    cjson_stats_allocator_free(stats);
+    document = cjson_document_new_with_arena(arena);
+    ck_assert_ptr_nonnull(document);
+    ck_assert_ptr_eq(cjson_document_allocator(document), arena);
+    cjson_document_free(document);
+}
+
+START_TEST(test_set_root) {
+    CJsonDocument* document = cjson_document_new(1024);
+    ck_assert_ptr_nonnull(document);
+
+    CJsonAllocator* allocator = cjson_document_allocator(document);
+    CJsonValue* root = CJSON_ARRAY_V_A(allocator, CJSON_TRUE_V_A(allocator), CJSON_NULL_V_A(allocator));
+    cjson_document_set_root(document, root);
+    ck_assert_ptr_eq(cjson_document_root(document), root);
+
+    cjson_document_free(document);
+}
+
+START_TEST(test_read) {
+    char data[] = RAW_JSON({"key": ["value", 42, null]});
+    CJsonDocument* document = cjson_document_read(data, 64 * 1024);
+    ck_assert_ptr_nonnull(document);
+
+    CJsonValue* expected = CJSON_OBJECT_V(
+        "key", CJSON_ARRAY_V(CJSON_STR_V("value"), CJSON_NUMBER_V(42), CJSON_NULL_V)
+    );
+    ck_assert(cjson_value_equals(cjson_document_root(document), expected));
+
+    cjson_value_free(expected);
+    cjson_document_free(document);
+}
+
+START_TEST(test_read_bad_input) {
+    char data[] = "[1, 2";
+    ck_assert_ptr_null(cjson_document_read(data, 64 * 1024));
+}
+
+START_TEST(test_read_presized) {
+    char data[] = RAW_JSON({"key": ["value", 42, null], "other": {"nested": true}});
+    CJsonDocument* document = cjson_document_read_presized(data);
+    ck_assert_ptr_nonnull(document);
+
+    CJsonValue* expected = CJSON_OBJECT_V(
+        "key", CJSON_ARRAY_V(CJSON_STR_V("value"), CJSON_NUMBER_V(42), CJSON_NULL_V),
+        "other", CJSON_OBJECT_V("nested", CJSON_TRUE_V)
+    );
+    ck_assert(cjson_value_equals(cjson_document_root(document), expected));
+
+    cjson_value_free(expected);
+    cjson_document_free(document);
+}
+
+START_TEST(test_read_file) {
+    const char data[] = RAW_JSON({"key": ["value", 42, "esc\"aped"]});
+    char path[] = "/tmp/cjson_document_read_file_XXXXXX";
+    const int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, data, strlen(data)), strlen(data));
+
+    CJsonReadOptions options = cjson_read_options_default();
+    options.in_situ = true;
+    options.lazy = true;
+    CJsonDocument* document = cjson_document_read_file(path, &options);
+    ck_assert_ptr_nonnull(document);
+    CJsonValue* expected = CJSON_OBJECT_V("key", CJSON_ARRAY_V(CJSON_STR_V("value"), CJSON_NUMBER_V(42), CJSON_STR_V("esc\"aped")));
+    ck_assert(cjson_value_equals(cjson_document_root(document), expected));
+    cjson_value_free(expected);
+    cjson_document_free(document);
+
+    // The strings decoded in place left the file untouched.
+    char contents[sizeof(data)] = {0};
+    ck_assert_int_eq(pread(fd, contents, sizeof(contents), 0), strlen(data));
+    ck_assert_str_eq(contents, data);
+    close(fd);
+    unlink(path);
+}
+
+START_TEST(test_read_parallel) {
+    char data[16 * 1024] = "[";
+    for(int i = 0; i < 400; ++i) {
+        char element[64];
+        snprintf(element, sizeof(element), "%s{\"id\": %d, \"tags\": [\"a,]\", []]}", i == 0 ? "" : ", ", i);
+        strcat(data, element);
+    }
+    strcat(data, "]\n");
+    CJsonParallelReadOptions options = cjson_parallel_read_options_default();
+    options.threads = 4;
+    options.min_slice_size = 256;
+    CJsonDocument* document = cjson_document_read_parallel(data, strlen(data), &options);
+    ck_assert_ptr_nonnull(document);
+    ck_assert_uint_eq(document->_arena_count, 4);
+
+    CJsonValue* expected = cjson_read(data, NULL);
+    ck_assert(cjson_value_equals(cjson_document_root(document), expected));
+    cjson_value_free(expected);
+    cjson_document_free(document);
+
+    const char empty[] = " [ ] ";
+    document = cjson_document_read_parallel(empty, strlen(empty), &options);
+    ck_assert_ptr_nonnull(document);
+    ck_assert(cjson_array_empty(cjson_value_get_array(cjson_document_root(document))));
+    cjson_document_free(document);
+}
+
+START_TEST(test_read_parallel_bad_input) {
+    CJsonParallelReadOptions options = cjson_parallel_read_options_default();
+    options.threads = 2;
+    options.min_slice_size = 8;
+    const char* inputs[] = {
+        "[{\"a\": 1}, {\"b\": 2}, {\"c\": 3},]",
+        "[{\"a\": 1}, {\"b\": 2}, {\"c\" 3}]",
+        "[{\"a\": 1}, {\"b\": 2}, {\"c\": 3}] x",
+        "[[[1]], [[2]], [[3]], [[4]]]"
+    };
+    options.max_depth = 2;
+    for(size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        ck_assert_ptr_null(cjson_document_read_parallel(inputs[i], strlen(inputs[i]), &options));
+    }
+}
+
+void document_case_setup(Suite* suite) {
+    TCase* document_case = tcase_create("document");
+    suite_add_tcase(suite, document_case);
+
+    tcase_add_test(document_case, test_new);
+    tcase_add_test(document_case, test_set_root);
+    tcase_add_test(document_case, test_read);
+    tcase_add_test(document_case, test_read_bad_input);
+    tcase_add_test(document_case, test_read_presized);
+    tcase_add_test(document_case, test_read_file);
+    tcase_add_test(document_case, test_read_parallel);
+    tcase_add_test(document_case, test_read_parallel_bad_input);
+}
@@ -0,0 +1,137 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_events.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef struct EventLog {
+    char text[512];
+    size_t size;
+    size_t events_before_stop;
+} EventLog;
+
+bool event_log_append(EventLog* log, const char* format, const char* data, size_t size) {
+    log->size += snprintf(log->text + log->size, sizeof(log->text) - log->size, format, (int) size, data);
+    return --log->events_before_stop > 0;
+}
+
+bool log_start_object(void* log) { return event_log_append(log, "{%.*s", "", 0); }
+bool log_end_object(void* log) { return event_log_append(log, "}%.*s", "", 0); }
+bool log_start_array(void* log) { return event_log_append(log, "[%.*s", "", 0); }
+bool log_end_array(void* log) { return event_log_append(log, "]%.*s", "", 0); }
+bool log_key(void* log, const char* data, size_t size) { return event_log_append(log, "k:%.*s ", data, size); }
+bool log_string(void* log, const char* data, size_t size) { return event_log_append(log, "s:%.*s ", data, size); }
+bool log_null(void* log) { return event_log_append(log, "null %.*s", "", 0); }
+
+bool log_number(void* log, double value) {
+    char number[32];
+    snprintf(number, sizeof(number), "%g", value);
+    return event_log_append(log, "n:%.*s ", number, strlen(number));
+}
+
+bool log_boolean(void* log, bool value) {
+    return event_log_append(log, "b:%.*s ", value ? "1" : "0", 1);
+}
+
+const CJsonHandler k_log_handler = {
+    .start_object = log_start_object,
+    .end_object = log_end_object,
+    .start_array = log_start_array,
+    .end_array = log_end_array,
+    .key = log_key,
+    .string = log_string,
+    .number = log_number,
+    .boolean = log_boolean,
+    .null = log_null
+};
+
+bool read_logged(const char* data, EventLog* log) {
+    log->size = 0;
+    log->text[0] = '\0';
+    if(log->events_before_stop == 0) { log->events_before_stop = (size_t) -1; }
+    return cjson_read_events(data, strlen(data), &k_log_handler, log);
+}
+
+START_TEST(test_events) {
+    EventLog log = {0};
+    ck_assert(read_logged(RAW_JSON({"a": [1.5, "x", null], "b": {"c": true}, "d": []}), &log));
+    ck_assert_str_eq(log.text, "{k:a [n:1.5 s:x null ]k:b {k:c b:1 }k:d []}");
+}
+
+START_TEST(test_scalar_root) {
+    EventLog log = {0};
+    ck_assert(read_logged("  -42e1", &log));
+    ck_assert_str_eq(log.text, "n:-420 ");
+}
+
+bool sum_number(void* sum, double value) {
+    *(double*) sum += value;
+    return true;
+}
+
+START_TEST(test_partial_handler) {
+    double sum = 0;
+    const CJsonHandler handler = { .number = sum_number };
+    const char data[] = RAW_JSON({"a": [1, "x", 2], "b": {"c": 3.5, "d": null}});
+    ck_assert(cjson_read_events(data, strlen(data), &handler, &sum));
+    ck_assert(sum == 6.5);
+}
+
+START_TEST(test_long_number_root) {
+    char* data = malloc(70);
+    data[0] = '1';
+    memset(data + 1, '0', 69);
+    double value = 0;
+    const CJsonHandler handler = { .number = sum_number };
+    ck_assert(cjson_read_events(data, 70, &handler, &value));
+    ck_assert(value == 1e69);
+    free(data);
+}
+
+START_TEST(test_stop) {
+    EventLog log = {0};
+    log.events_before_stop = 3;
+    ck_assert(!read_logged(RAW_JSON([1, 2, 3, 4]), &log));
+    ck_assert_str_eq(log.text, "[n:1 n:2 ");
+}
+
+START_TEST(test_bad_input) {
+    EventLog log = {0};
+    ck_assert(!read_logged("[1, 2,]", &log));
+    ck_assert(!read_logged("{\"a\": 1]", &log));
+    ck_assert(!read_logged("{\"a\" 1}", &log));
+    ck_assert(!read_logged("[1] 2", &log));
+    ck_assert(!read_logged("[nul]", &log));
+    ck_assert(!read_logged("\"open", &log));
+    ck_assert(!read_logged("", &log));
+}
+
+START_TEST(test_max_depth) {
+    char data[2 * CJSON_EVENTS_MAX_DEPTH + 3];
+    memset(data, '[', CJSON_EVENTS_MAX_DEPTH + 1);
+    memset(data + CJSON_EVENTS_MAX_DEPTH + 1, ']', CJSON_EVENTS_MAX_DEPTH + 1);
+    const CJsonHandler handler = {0};
+    ck_assert(!cjson_read_events(data, 2 * CJSON_EVENTS_MAX_DEPTH + 2, &handler, NULL));
+    ck_assert(cjson_read_events(data + 1, 2 * CJSON_EVENTS_MAX_DEPTH, &handler, NULL));
+}
+
+void events_case_setup(Suite* suite) {
+    TCase* events_case = tcase_create("events");
+    suite_add_tcase(suite, events_case);
+
+    tcase_add_test(events_case, test_events);
+    tcase_add_test(events_case, test_scalar_root);
+    tcase_add_test(events_case, test_partial_handler);
+    tcase_add_test(events_case, test_long_number_root);
+    tcase_add_test(events_case, test_stop);
+    tcase_add_test(events_case, test_bad_input);
+    tcase_add_test(events_case, test_max_depth);
+}
@@ -0,0 +1,111 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#define _GNU_SOURCE
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_file_reader.h>
+#include <cjson_value.h>
+#include <cjson_object.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FILE_COUNT 40
+
+
+typedef struct FileResults {
+    double ids[FILE_COUNT];
+    int errors[FILE_COUNT];
+    size_t seen[FILE_COUNT];
+    size_t records;
+    size_t stop_after;
+} FileResults;
+
+bool collect_file(void* context, const CJsonFileRecord* record) {
+    FileResults* results = (FileResults*) context;
+    ++results->seen[record->index];
+    results->errors[record->index] = record->error;
+    results->ids[record->index] = -1;
+    if(record->value != NULL) {
+        results->ids[record->index] = *cjson_value_get_number(cjson_object_get(cjson_value_get_object(record->value), "id"));
+        cjson_value_free(record->value);
+    }
+    return ++results->records != results->stop_after;
+}
+
+// File i holds {"id": i}, except for a malformed one and a missing one.
+void make_files(char* directory, char paths[FILE_COUNT][64]) {
+    ck_assert_ptr_nonnull(mkdtemp(directory));
+    for(size_t i = 0; i < FILE_COUNT; ++i) {
+        snprintf(paths[i], 64, "%s/%zu.json", directory, i);
+        if(i == 7) { continue; }
+        FILE* file = fopen(paths[i], "w");
+        ck_assert_ptr_nonnull(file);
+        fprintf(file, i == 3 ? "{\"id\": " : "{\"id\": %zu, \"padding\": \"%0*d\"}", i, (int) (i * 1000), 0);
+        fclose(file);
+    }
+}
+
+void remove_files(const char* directory, char paths[FILE_COUNT][64]) {
+    for(size_t i = 0; i < FILE_COUNT; ++i) {
+        unlink(paths[i]);
+    }
+    rmdir(directory);
+}
+
+void check_read_files(bool io_uring) {
+    char directory[] = "/tmp/cjson_read_files_XXXXXX";
+    char paths[FILE_COUNT][64];
+    const char* path_list[FILE_COUNT];
+    make_files(directory, paths);
+    for(size_t i = 0; i < FILE_COUNT; ++i) {
+        path_list[i] = paths[i];
+    }
+
+    CJsonReadFilesOptions options = cjson_read_files_options_default();
+    options.io_uring = io_uring;
+    options.queue_depth = 8;
+    options.threads = 3;
+    FileResults results = {.records = 0, .stop_after = 0};
+    memset(results.seen, 0, sizeof(results.seen));
+    ck_assert(cjson_read_files(path_list, FILE_COUNT, &options, collect_file, &results, NULL));
+    ck_assert_uint_eq(results.records, FILE_COUNT);
+    for(size_t i = 0; i < FILE_COUNT; ++i) {
+        ck_assert_uint_eq(results.seen[i], 1);
+        if(i == 7) {
+            ck_assert_int_eq(results.errors[i], ENOENT);
+        } else {
+            ck_assert_int_eq(results.errors[i], 0);
+            ck_assert_double_eq(results.ids[i], i == 3 ? -1 : (double) i);
+        }
+    }
+
+    results.records = 0;
+    results.stop_after = 5;
+    ck_assert(!cjson_read_files(path_list, FILE_COUNT, &options, collect_file, &results, NULL));
+    ck_assert_uint_eq(results.records, 5);
+
+    remove_files(directory, paths);
+}
+
+START_TEST(test_read_files) {
+    check_read_files(true);
+}
+
+START_TEST(test_read_files_threads) {
+    check_read_files(false);
+}
+
+void file_reader_case_setup(Suite* suite) {
+    TCase* file_reader_case = tcase_create("file_reader");
+    suite_add_tcase(suite, file_reader_case);
+
+    tcase_add_test(file_reader_case, test_read_files);
+    tcase_add_test(file_reader_case, test_read_files_threads);
+}
@@ -0,0 +1,219 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_allocator.h>
+#include <cjson_allocator_stats.h>
+#include <cjson_parser.h>
+#include <cjson_reader.h>
+#include <cjson_value.h>
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_str.h>
+
+#include <string.h>
+
+
+CJsonValue* parse_in_chunks(const char* data, size_t chunk_size) {
+    CJsonParser* parser = cjson_parser_new(NULL);
+    const size_t size = strlen(data);
+    for(size_t offset = 0; offset < size; offset += chunk_size) {
+        cjson_parser_feed(parser, data + offset, CJSON_MIN(chunk_size, size - offset));
+    }
+    CJsonValue* value = cjson_parser_finish(parser);
+    cjson_parser_free(parser);
+    return value;
+}
+
+START_TEST(test_single_chunk) {
+    CJsonValue* value = parse_in_chunks(RAW_JSON({"key": ["value", 42, null, true, false, {}, []]}), 4096);
+    CJsonValue* expected = CJSON_OBJECT_V(
+        "key", CJSON_ARRAY_V(
+            CJSON_STR_V("value"), CJSON_NUMBER_V(42), CJSON_NULL_V, CJSON_TRUE_V, CJSON_FALSE_V,
+            CJSON_EMPTY_OBJECT_V, CJSON_EMPTY_ARRAY_V
+        )
+    );
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_every_split) {
+    char data[] = "{\"a\": [1.5e3, -2, \"x\\\"y\\\\\"], \"bb\": {\"c\": null, \"dd\": [true, false]}, \"e\": \"\"}";
+    CJsonValue* expected = cjson_read(data, NULL);
+    ck_assert_ptr_nonnull(expected);
+
+    const size_t size = strlen(data);
+    for(size_t split = 0; split <= size; ++split) {
+        CJsonParser* parser = cjson_parser_new(NULL);
+        ck_assert(cjson_parser_feed(parser, data, split));
+        ck_assert(cjson_parser_feed(parser, data + split, size - split));
+        CJsonValue* value = cjson_parser_finish(parser);
+        ck_assert_ptr_nonnull(value);
+        ck_assert(cjson_value_equals(value, expected));
+        cjson_value_free(value);
+        cjson_parser_free(parser);
+    }
+    cjson_value_free(expected);
+}
+
+START_TEST(test_byte_by_byte) {
+    CJsonValue* value = parse_in_chunks(RAW_JSON([12345, "a somewhat longer string", {"key": -0.25}]), 1);
+    CJsonValue* expected = CJSON_ARRAY_V(
+        CJSON_NUMBER_V(12345), CJSON_STR_V("a somewhat longer string"), CJSON_OBJECT_V("key", CJSON_NUMBER_V(-0.25))
+    );
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_scalar_root) {
+    CJsonValue* value = parse_in_chunks("  42", 1);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(*CJSON_AS_NUMBER(value) == 42);
+    cjson_value_free(value);
+}
+
+START_TEST(test_bad_input) {
+    ck_assert_ptr_null(parse_in_chunks("[1, 2,]", 3));
+    ck_assert_ptr_null(parse_in_chunks("[1, 2}", 3));
+    ck_assert_ptr_null(parse_in_chunks("{\"a\" 1}", 3));
+    ck_assert_ptr_null(parse_in_chunks("[1] 2", 3));
+    ck_assert_ptr_null(parse_in_chunks("[tru]", 3));
+    ck_assert_ptr_null(parse_in_chunks("[1, 2", 3));
+    ck_assert_ptr_null(parse_in_chunks("\"open", 3));
+    ck_assert_ptr_null(parse_in_chunks("", 3));
+}
+
+START_TEST(test_error_offset) {
+    CJsonParser* parser = cjson_parser_new(NULL);
+    ck_assert(cjson_parser_feed(parser, "[1, 2", 5));
+    ck_assert(!cjson_parser_feed(parser, ", ]", 3));
+    ck_assert(cjson_parser_failed(parser));
+    ck_assert_uint_eq(cjson_parser_offset(parser), 7);
+    ck_assert(!cjson_parser_feed(parser, "3]", 2));
+    ck_assert_ptr_null(cjson_parser_finish(parser));
+    cjson_parser_free(parser);
+}
+
+START_TEST(test_linear_allocator) {
+    char data[] = RAW_JSON({"key": ["value", 42]});
+    CJsonAllocator* allocator = cjson_linear_allocator_new(64 * 1024);
+    CJsonParser* parser = cjson_parser_new(allocator);
+    ck_assert(cjson_parser_feed(parser, data, 10));
+    ck_assert(cjson_parser_feed(parser, data + 10, strlen(data) - 10));
+    CJsonValue* value = cjson_parser_finish(parser);
+    cjson_parser_free(parser);
+
+    CJsonValue* expected = CJSON_OBJECT_V("key", CJSON_ARRAY_V(CJSON_STR_V("value"), CJSON_NUMBER_V(42)));
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(expected);
+    cjson_linear_allocator_free(allocator);
+}
+
+START_TEST(test_reset) {
+    CJsonParser* parser = cjson_parser_new(NULL);
+    ck_assert(cjson_parser_feed(parser, "[1, {\"a\": ", 10));
+    cjson_parser_reset(parser, NULL);
+
+    CJsonValue* value = cjson_parser_read(parser, "[\"b\"]", 5);
+    CJsonValue* expected = CJSON_ARRAY_V(CJSON_STR_V("b"));
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(value);
+    cjson_value_free(expected);
+
+    cjson_parser_reset(parser, NULL);
+    cjson_parser_set_max_depth(parser, 1);
+    ck_assert_ptr_null(cjson_parser_read(parser, "[[]]", 4));
+    cjson_parser_free(parser);
+}
+
+START_TEST(test_limits) {
+    const char data[] = RAW_JSON({"key": ["a string of 25 characters", 12345]});
+    const size_t size = strlen(data);
+    CJsonParser* parser = cjson_parser_new(NULL);
+    ck_assert_int_eq(cjson_parser_error(parser), cjson_no_parse_error);
+
+    CJsonParserLimits limits = {.max_string_length = 25};
+    cjson_parser_set_limits(parser, &limits);
+    for(size_t i = 0; i < size; ++i) {
+        cjson_parser_feed(parser, data + i, 1);
+    }
+    CJsonValue* value = cjson_parser_finish(parser);
+    ck_assert_ptr_nonnull(value);
+    cjson_value_free(value);
+
+    // The string is given up on before it is complete.
+    cjson_parser_reset(parser, NULL);
+    limits.max_string_length = 24;
+    cjson_parser_set_limits(parser, &limits);
+    size_t fed = 0;
+    while(cjson_parser_feed(parser, data + fed, 1)) {
+        ++fed;
+    }
+    ck_assert_uint_lt(fed, strstr(data, "\"]") - data);
+    ck_assert_int_eq(cjson_parser_error(parser), cjson_string_length_parse_error);
+
+    cjson_parser_reset(parser, NULL);
+    ck_assert_int_eq(cjson_parser_error(parser), cjson_no_parse_error);
+    CJsonParserLimits size_limits = {.max_size = size - 1};
+    cjson_parser_set_limits(parser, &size_limits);
+    ck_assert(cjson_parser_feed(parser, data, size - 1));
+    ck_assert(!cjson_parser_feed(parser, data + size - 1, 1));
+    ck_assert_int_eq(cjson_parser_error(parser), cjson_size_parse_error);
+    ck_assert_uint_eq(cjson_parser_offset(parser), size - 1);
+
+    cjson_parser_reset(parser, NULL);
+    cjson_parser_set_limits(parser, NULL);
+    ck_assert_ptr_null(cjson_parser_read(parser, "[1,]", 4));
+    ck_assert_int_eq(cjson_parser_error(parser), cjson_syntax_parse_error);
+    cjson_parser_free(parser);
+}
+
+START_TEST(test_pool) {
+    CJsonParser* parser = cjson_parser_acquire();
+    cjson_parser_release(parser);
+    ck_assert_ptr_eq(cjson_parser_acquire(), parser);
+    cjson_parser_release(parser);
+
+    // A warm pool leaves only the values to allocate.
+    CJsonAllocator* allocator = cjson_stats_allocator_new(NULL);
+    CJsonValue* value = cjson_read(RAW_JSON({"key": [1, 2, 3]}), allocator);
+    ck_assert_ptr_nonnull(value);
+    ck_assert_uint_eq(cjson_allocator_stats(allocator)->by_kind[cjson_reader_allocation].allocs, 0);
+    cjson_value_free(value);
+
+    // Parsers whose scratch state comes from another allocator are freed rather than pooled.
+    cjson_allocator_stats_reset(allocator);
+    CJsonParser* owned_parser = cjson_parser_new(allocator);
+    cjson_parser_release(owned_parser);
+    ck_assert_uint_eq(cjson_allocator_stats(allocator)->total.live_bytes, 0);
+    ck_assert_ptr_eq(cjson_parser_acquire(), parser);
+    cjson_parser_release(parser);
+    cjson_stats_allocator_free(allocator);
+    cjson_parser_pool_clear();
+}
+
+void parser_case_setup(Suite* suite) {
+    TCase* parser_case = tcase_create("parser");
+    suite_add_tcase(suite, parser_case);
+
+    tcase_add_test(parser_case, test_single_chunk);
+    tcase_add_test(parser_case, test_every_split);
+    tcase_add_test(parser_case, test_byte_by_byte);
+    tcase_add_test(parser_case, test_scalar_root);
+    tcase_add_test(parser_case, test_bad_input);
+    tcase_add_test(parser_case, test_error_offset);
+    tcase_add_test(parser_case, test_linear_allocator);
+    tcase_add_test(parser_case, test_reset);
+    tcase_add_test(parser_case, test_limits);
+    tcase_add_test(parser_case, test_pool);
+}
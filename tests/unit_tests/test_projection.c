@@ -0,0 +1,89 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_allocator_stats.h>
+#include <cjson_parser.h>
+#include <cjson_projection.h>
+#include <cjson_value.h>
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_str.h>
+
+#include <string.h>
+
+
+const char k_order[] = RAW_JSON({
+    "user": {"id": 7, "name": "ada", "a/b": 1, "tags": ["x", "}"]},
+    "items": [{"price": 3, "sku": "p-1"}, {"sku": "p-2"}, {"price": 5, "sku": "p-3"}],
+    "notes": "[skipped]"
+});
+
+START_TEST(test_project_paths) {
+    const char* paths[] = {"/user/id", "/items/*/price", "/user/a~1b"};
+    CJsonValue* value = cjson_read_projected(k_order, strlen(k_order), paths, 3, NULL);
+    CJsonValue* expected = CJSON_OBJECT_V(
+        "user", CJSON_OBJECT_V("id", CJSON_NUMBER_V(7), "a/b", CJSON_NUMBER_V(1)),
+        "items", CJSON_ARRAY_V(CJSON_OBJECT_V("price", CJSON_NUMBER_V(3)), CJSON_OBJECT_V("price", CJSON_NUMBER_V(5)))
+    );
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_project_index_and_wildcard) {
+    const char* paths[] = {"/items/1", "/items/*/price"};
+    CJsonValue* value = cjson_read_projected(k_order, strlen(k_order), paths, 2, NULL);
+    CJsonValue* expected = CJSON_OBJECT_V(
+        "items", CJSON_ARRAY_V(
+            CJSON_OBJECT_V("price", CJSON_NUMBER_V(3)),
+            CJSON_OBJECT_V("sku", CJSON_STR_V("p-2")),
+            CJSON_OBJECT_V("price", CJSON_NUMBER_V(5)))
+    );
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_project_skips_without_allocating) {
+    const char* paths[] = {"/missing"};
+    CJsonAllocator* allocator = cjson_stats_allocator_new(NULL);
+    cjson_value_free(CJSON_EMPTY_OBJECT_V_A(allocator));
+    const size_t empty_object_allocs = cjson_allocator_stats(allocator)->total.allocs;
+
+    // Only the empty root is allocated.
+    CJsonValue* value = cjson_read_projected(k_order, strlen(k_order), paths, 1, allocator);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_is_object(value));
+    ck_assert_uint_eq(cjson_object_size(cjson_value_get_object(value)), 0);
+    cjson_value_free(value);
+    ck_assert_uint_eq(cjson_allocator_stats(allocator)->total.allocs, 2 * empty_object_allocs);
+    cjson_stats_allocator_free(allocator);
+    cjson_parser_pool_clear();
+}
+
+START_TEST(test_project_bad_input) {
+    const char* bad_pointer[] = {"user"};
+    ck_assert_ptr_null(cjson_read_projected(k_order, strlen(k_order), bad_pointer, 1, NULL));
+    const char* bad_escape[] = {"/user~2"};
+    ck_assert_ptr_null(cjson_read_projected(k_order, strlen(k_order), bad_escape, 1, NULL));
+
+    const char* paths[] = {"/a"};
+    const char truncated[] = "{\"b\": [1, 2, {\"a\": 1}], \"a\": [1, ";
+    ck_assert_ptr_null(cjson_read_projected(truncated, strlen(truncated), paths, 1, NULL));
+}
+
+void projection_case_setup(Suite* suite) {
+    TCase* projection_case = tcase_create("projection");
+    suite_add_tcase(suite, projection_case);
+
+    tcase_add_test(projection_case, test_project_paths);
+    tcase_add_test(projection_case, test_project_index_and_wildcard);
+    tcase_add_test(projection_case, test_project_skips_without_allocating);
+    tcase_add_test(projection_case, test_project_bad_input);
+}
@@ -2,15 +2,24 @@
 // Created by Jean-Edouard BOULANGER on 26/12/2020.
 //
 
+#define _GNU_SOURCE
+
 #include "cases.h"
 #include "helpers.h"
 
+#include <cjson_allocator.h>
+#include <cjson_allocator_stats.h>
 #include <cjson_reader.h>
 #include <cjson_value.h>
 #include <cjson_array.h>
 #include <cjson_object.h>
 #include <cjson_str.h>
 #include <cjson_stringstream.h>
+#include <cjson_writer.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 
 START_GOOD_READ_TEST(test_good_lonely_null,
@@ -236,6 +245,239 @@ START_BAD_READ_TEST(test_bad_lonely_string, "\"bad string")
 START_BAD_READ_TEST(test_array_missing_right_bracket, "\"[1, 2, 3")
 START_BAD_READ_TEST(test_array_trailing_comma, "\"[1, 2, 3,]")
 
+START_TEST(test_presized_read) {
+    char data[] = RAW_JSON({"a": [1, [], {}, ["x", "y\\"], {"k": null, "l": [true]}], "b": "c"});
+    CJsonValue* expected = cjson_read(data, NULL);
+    ck_assert_ptr_nonnull(expected);
+
+    CJsonValue* value = cjson_read_presized(data, NULL);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_arena_size_is_exact) {
+    char data[] = RAW_JSON({"list": [1, 2.5, "three", {"four": 4}], "empty": {}, "nested": [[[]]]});
+    const size_t arena_size = cjson_read_arena_size(data);
+    ck_assert_uint_gt(arena_size, 0);
+
+    CJsonAllocator* arena = cjson_linear_allocator_new(arena_size);
+    CJsonValue* value = cjson_read_presized(data, arena);
+    ck_assert_ptr_nonnull(value);
+    ck_assert_uint_eq(((CJsonLinearAllocatorContext*) arena->context)->size, arena_size);
+    cjson_linear_allocator_free(arena);
+}
+
+START_TEST(test_arena_size_bad_input) {
+    ck_assert_uint_eq(cjson_read_arena_size("[1, 2"), 0);
+    ck_assert_uint_eq(cjson_read_arena_size("{\"a\": [}"), 0);
+    ck_assert_uint_eq(cjson_read_arena_size("\"open"), 0);
+}
+
+START_TEST(test_deep_nesting) {
+    const size_t depth = (size_t) 1 << 20;
+    char* data = (char*) malloc(2 * depth + 1);
+    memset(data, '[', depth);
+    memset(data + depth, ']', depth);
+    data[2 * depth] = '\0';
+
+    // Neither reading nor freeing a tree this deep recurses.
+    CJsonValue* value = cjson_read(data, NULL);
+    ck_assert_ptr_nonnull(value);
+    cjson_value_free(value);
+    // Failed reads free the partial tree.
+    data[2 * depth - 1] = '\0';
+    ck_assert_ptr_null(cjson_read(data, NULL));
+    data[depth] = '\0';
+    ck_assert_ptr_null(cjson_read(data, NULL));
+    data[depth] = ']';
+    data[2 * depth - 1] = ']';
+
+    CJsonAllocator* arena = cjson_mapped_linear_allocator_new(depth * 1024, 0, cjson_mapped_arena_no_flags);
+    ck_assert_ptr_nonnull(cjson_read(data, arena));
+
+    CJsonReadOptions options = cjson_read_options_default();
+    options.max_depth = depth - 1;
+    ck_assert_ptr_null(cjson_read_with_options(data, &options, arena));
+    options.max_depth = depth;
+    ck_assert_ptr_nonnull(cjson_read_with_options(data, &options, arena));
+
+    cjson_linear_allocator_free(arena);
+    free(data);
+}
+
+START_TEST(test_read_budgets) {
+    char data[] = RAW_JSON({"items": [1, 2, 3, {"name": "twelve chars"}], "deep": [[[]]]});
+    const size_t size = strlen(data);
+    for(int presize = 0; presize < 2; ++presize) {
+        CJsonReadOptions options = cjson_read_options_default();
+        options.presize = presize;
+        options.max_size = size;
+        options.max_depth = 4;
+        options.max_string_length = 12;
+        // The root, the items array, its three numbers, object and string, and three nested arrays.
+        options.max_values = 10;
+        options.max_memory = 1 << 16;
+        CJsonParseError error = cjson_syntax_parse_error;
+        CJsonValue* value = cjson_read_bytes_with_error(data, size, &options, NULL, &error);
+        ck_assert_ptr_nonnull(value);
+        ck_assert_int_eq(error, cjson_no_parse_error);
+        cjson_value_free(value);
+
+        const struct { size_t* budget; CJsonParseError error; } budgets[] = {
+            {&options.max_size, cjson_size_parse_error},
+            {&options.max_depth, cjson_depth_parse_error},
+            {&options.max_string_length, cjson_string_length_parse_error},
+            {&options.max_values, cjson_value_count_parse_error}
+        };
+        for(size_t i = 0; i < sizeof(budgets) / sizeof(budgets[0]); ++i) {
+            *budgets[i].budget -= 1;
+            ck_assert_ptr_null(cjson_read_bytes_with_error(data, size, &options, NULL, &error));
+            ck_assert_int_eq(error, budgets[i].error);
+            *budgets[i].budget += 1;
+        }
+        options.max_memory = 64;
+        ck_assert_ptr_null(cjson_read_bytes_with_error(data, size, &options, NULL, &error));
+        ck_assert_int_eq(error, cjson_memory_parse_error);
+    }
+
+    CJsonParseError error = cjson_no_parse_error;
+    ck_assert_ptr_null(cjson_read_bytes_with_error("[1, 2", 5, NULL, NULL, &error));
+    ck_assert_int_eq(error, cjson_syntax_parse_error);
+}
+
+START_TEST(test_presized_read_budgets) {
+    // The prescan fails on the first container over budget, before the parser runs.
+    const size_t count = 100000;
+    char* data = (char*) malloc(2 * count);
+    memset(data, '[', count);
+    memset(data + count, ']', count);
+    CJsonReadOptions options = cjson_read_options_default();
+    options.presize = true;
+    options.max_depth = 8;
+    CJsonParseError error = cjson_no_parse_error;
+    ck_assert_ptr_null(cjson_read_bytes_with_error(data, 2 * count, &options, NULL, &error));
+    ck_assert_int_eq(error, cjson_depth_parse_error);
+
+    for(size_t i = 1; i + 1 < count; i += 3) {
+        memcpy(data + i, "[],", 3);
+    }
+    data[0] = '[';
+    data[count - 1] = ']';
+    options.max_depth = 0;
+    options.max_values = 8;
+    ck_assert_ptr_null(cjson_read_bytes_with_error(data, count, &options, NULL, &error));
+    ck_assert_int_eq(error, cjson_value_count_parse_error);
+    free(data);
+}
+
+START_TEST(test_lazy_read) {
+    char data[] = RAW_JSON({"name": "ada", "scores": [1.5, -2e3, "x"], "empty": ""});
+    CJsonValue* expected = cjson_read(data, NULL);
+    CJsonAllocator* allocator = cjson_stats_allocator_new(NULL);
+    CJsonReadOptions options = cjson_read_options_default();
+    options.lazy = true;
+
+    CJsonValue* value = cjson_read_with_options(data, &options, allocator);
+    ck_assert_ptr_nonnull(value);
+    const CJsonAllocatorStats* stats = cjson_allocator_stats(allocator);
+    // Only the empty string, which has no bytes to point to, is decoded upfront.
+    const size_t upfront_allocs = stats->by_kind[cjson_str_allocation].allocs;
+    ck_assert_uint_gt(upfront_allocs, 0);
+
+    CJsonValue* name = cjson_object_get(cjson_value_get_object(value), "name");
+    ck_assert_str_eq(CJSON_AS_RAW_STR(name), "ada");
+    ck_assert_uint_eq(stats->by_kind[cjson_str_allocation].allocs, 2 * upfront_allocs);
+    // Neither comparing nor writing decodes anything.
+    ck_assert(cjson_value_equals(value, expected));
+    char* str = cjson_to_str(value, NULL);
+    char* expected_str = cjson_to_str(expected, NULL);
+    ck_assert_str_eq(str, expected_str);
+    ck_assert_uint_eq(stats->by_kind[cjson_str_allocation].allocs, 2 * upfront_allocs);
+    free(expected_str);
+    free(str);
+
+    cjson_value_free(value);
+    cjson_value_free(expected);
+    cjson_stats_allocator_free(allocator);
+}
+
+START_TEST(test_escapes) {
+    char data[] = "{\"k\\u00e9y\": \"a\\\"b\\\\c\\/\\n\\u00e9\\ud83d\\ude00\"}";
+    CJsonValue* value = cjson_read(data, NULL);
+    CJsonValue* expected = CJSON_OBJECT_V("k\xc3\xa9y", CJSON_STR_V("a\"b\\c/\n\xc3\xa9\xf0\x9f\x98\x80"));
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+
+    // Written back, the strings read the same.
+    char* written = cjson_to_str(value, NULL);
+    CJsonValue* read_back = cjson_read(written, NULL);
+    ck_assert_ptr_nonnull(read_back);
+    ck_assert(cjson_value_equals(read_back, expected));
+
+    free(written);
+    cjson_value_free(read_back);
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_in_situ_read) {
+    char data[] = RAW_JSON(["plain", "esc\"aped", {"key": "value"}]);
+    CJsonReadOptions options = cjson_read_options_default();
+    options.in_situ = true;
+
+    CJsonValue* value = cjson_read_with_options(data, &options, NULL);
+    CJsonValue* expected = CJSON_ARRAY_V(CJSON_STR_V("plain"), CJSON_STR_V("esc\"aped"), CJSON_OBJECT_V("key", CJSON_STR_V("value")));
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    const char* plain = CJSON_AS_RAW_STR(cjson_array_at(cjson_value_get_array(value), 0));
+    ck_assert(plain > data && plain < data + sizeof(data));
+
+    cjson_value_free(value);
+    cjson_value_free(expected);
+}
+
+START_TEST(test_read_file) {
+    const char data[] = RAW_JSON({"key": ["value", 42, null]});
+    CJsonValue* expected = CJSON_OBJECT_V("key", CJSON_ARRAY_V(CJSON_STR_V("value"), CJSON_NUMBER_V(42), CJSON_NULL_V));
+
+    // Mapped, without a NUL terminator.
+    char path[] = "/tmp/cjson_read_file_XXXXXX";
+    const int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, data, strlen(data)), strlen(data));
+    close(fd);
+    CJsonValue* value = cjson_read_file(path, NULL, NULL);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(value);
+    unlink(path);
+    ck_assert_ptr_null(cjson_read_file(path, NULL, NULL));
+
+    // Buffered.
+    int pipe_fds[2];
+    ck_assert_int_eq(pipe(pipe_fds), 0);
+    ck_assert_int_eq(write(pipe_fds[1], data, strlen(data)), strlen(data));
+    close(pipe_fds[1]);
+    char pipe_path[32];
+    snprintf(pipe_path, sizeof(pipe_path), "/dev/fd/%d", pipe_fds[0]);
+    value = cjson_read_file(pipe_path, NULL, NULL);
+    ck_assert_ptr_nonnull(value);
+    ck_assert(cjson_value_equals(value, expected));
+    cjson_value_free(value);
+    close(pipe_fds[0]);
+
+    cjson_value_free(expected);
+}
+
+START_BAD_READ_TEST(test_bad_escape, "[\"\\x\"]")
+START_BAD_READ_TEST(test_bad_unicode_escape, "[\"\\u12g4\"]")
+
+START_BAD_READ_TEST(test_object_leading_comma, "{, \"a\": 1}")
+START_BAD_READ_TEST(test_bad_nested_value, "{\"a\": [1, {\"b\": \"c\"}, tru]}")
+
 void reader_case_setup(Suite* suite) {
     TCase* reader_case = tcase_create("reader");
     suite_add_tcase(suite, reader_case);
@@ -272,4 +514,19 @@ void reader_case_setup(Suite* suite) {
     tcase_add_test(reader_case, test_bad_lonely_string);
     tcase_add_test(reader_case, test_array_missing_right_bracket);
     tcase_add_test(reader_case, test_array_trailing_comma);
+
+    tcase_add_test(reader_case, test_presized_read);
+    tcase_add_test(reader_case, test_arena_size_is_exact);
+    tcase_add_test(reader_case, test_arena_size_bad_input);
+    tcase_add_test(reader_case, test_deep_nesting);
+    tcase_add_test(reader_case, test_read_budgets);
+    tcase_add_test(reader_case, test_presized_read_budgets);
+    tcase_add_test(reader_case, test_object_leading_comma);
+    tcase_add_test(reader_case, test_bad_nested_value);
+    tcase_add_test(reader_case, test_lazy_read);
+    tcase_add_test(reader_case, test_escapes);
+    tcase_add_test(reader_case, test_in_situ_read);
+    tcase_add_test(reader_case, test_read_file);
+    tcase_add_test(reader_case, test_bad_escape);
+    tcase_add_test(reader_case, test_bad_unicode_escape);
 }
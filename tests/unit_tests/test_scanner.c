@@ -0,0 +1,48 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_scanner.h>
+
+#include <string.h>
+
+
+START_TEST(test_string_end) {
+    const char data[] = "\"a long enough string to span more than one vector\": 1";
+    const char* end = data + strlen(data);
+    ck_assert_ptr_eq(cjson_scan_string_end(data + 1, end), strchr(data + 1, '"'));
+}
+
+START_TEST(test_string_end_escapes) {
+    const char data[] = "\"\\\"quoted\\\" \\\\\" tail";
+    const char* end = data + strlen(data);
+    ck_assert_ptr_eq(cjson_scan_string_end(data + 1, end), data + 14);
+}
+
+START_TEST(test_string_end_unterminated) {
+    const char data[] = "\"no closing quote, even past the first vector of bytes\\\"";
+    const char* end = data + strlen(data);
+    ck_assert_ptr_null(cjson_scan_string_end(data + 1, end));
+}
+
+START_TEST(test_structural) {
+    const char data[] = "    12345678901234567890,    true]";
+    const char* end = data + strlen(data);
+    const char* comma = cjson_scan_structural(data, end);
+    ck_assert_ptr_eq(comma, strchr(data, ','));
+    ck_assert_ptr_eq(cjson_scan_structural(comma + 1, end), end - 1);
+    ck_assert_ptr_eq(cjson_scan_structural(end, end), end);
+}
+
+void scanner_case_setup(Suite* suite) {
+    TCase* scanner_case = tcase_create("scanner");
+    suite_add_tcase(suite, scanner_case);
+
+    tcase_add_test(scanner_case, test_string_end);
+    tcase_add_test(scanner_case, test_string_end_escapes);
+    tcase_add_test(scanner_case, test_string_end_unterminated);
+    tcase_add_test(scanner_case, test_structural);
+}
@@ -9,6 +9,9 @@
 #include <cjson_str.h>
 #include <cjson_stringstream.h>
 
+#include <cjson_utils.h>
+
+#include <stdlib.h>
 #include <string.h>
 
 
@@ -54,6 +57,55 @@ START_TEST(test_copy) {
     cjson_str_free(s2);
 }
 
+START_TEST(test_view) {
+    char data[] = "borrowed";
+    CJsonStr* s = cjson_str_new_view(data, 3, NULL);
+    data[3] = '\0';
+    ck_assert_ptr_eq(cjson_str_raw(s), data);
+    ck_assert_str_eq(cjson_str_raw(s), "bor");
+
+    // Modifying a view leaves the borrowed bytes untouched.
+    cjson_str_append_raw_string(s, "ing");
+    ck_assert_str_eq(cjson_str_raw(s), "boring");
+    ck_assert_str_eq(data, "bor");
+
+    cjson_str_free(s);
+}
+
+// Serves a single allocation, then runs out of memory.
+void* single_allocation_alloc(void* context, size_t size) {
+    bool* allocated = (bool*) context;
+    if(*allocated) { return NULL; }
+    *allocated = true;
+    return malloc(size);
+}
+
+void* single_allocation_realloc(CJSON_UNUSED void* context, void* address, size_t size) {
+    return realloc(address, size);
+}
+
+void single_allocation_dealloc(CJSON_UNUSED void* context, void* address) {
+    free(address);
+}
+
+START_TEST(test_view_out_of_memory) {
+    bool allocated = false;
+    CJsonAllocator allocator = CJSON_ALLOCATOR_INIT(single_allocation_alloc, single_allocation_realloc, single_allocation_dealloc, &allocated);
+    char data[] = "borrowed";
+    CJsonStr* s = cjson_str_new_view(data, 3, &allocator);
+    ck_assert_ptr_nonnull(s);
+
+    // Without a copy of its own, the view is left as it was.
+    cjson_str_append_raw_string(s, "ing");
+    cjson_str_pop_back(s);
+    cjson_str_clear(s);
+    ck_assert_ptr_eq(cjson_str_raw(s), data);
+    ck_assert_int_eq(cjson_str_length(s), 3);
+    ck_assert_str_eq(data, "borrowed");
+
+    cjson_str_free(s);
+}
+
 START_TEST(test_clear) {
     CJsonStr* s = cjson_str_new_from_raw("test_clear", NULL);
     ck_assert_ptr_nonnull(s);
@@ -292,6 +344,8 @@ void str_case_setup(Suite* suite) {
     tcase_add_test(str_case, test_new_from_raw);
     tcase_add_test(str_case, test_new_of_size);
     tcase_add_test(str_case, test_copy);
+    tcase_add_test(str_case, test_view);
+    tcase_add_test(str_case, test_view_out_of_memory);
     tcase_add_test(str_case, test_clear);
     tcase_add_test(str_case, test_append_raw_string);
     tcase_add_test(str_case, test_append);
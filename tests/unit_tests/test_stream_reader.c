@@ -0,0 +1,166 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_stream_reader.h>
+#include <cjson_value.h>
+#include <cjson_object.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+
+typedef struct StreamResult {
+    double ids[16];
+    size_t count;
+    size_t failures;
+} StreamResult;
+
+bool collect_ids(void* context, const CJsonStreamRecord* record) {
+    StreamResult* result = (StreamResult*) context;
+    ck_assert_uint_eq(record->index, result->count);
+    if(record->value == NULL) {
+        ++result->failures;
+        result->ids[result->count++] = -1;
+        return true;
+    }
+    result->ids[result->count++] = *CJSON_AS_NUMBER(cjson_object_get(CJSON_AS_OBJECT(record->value), "id"));
+    return true;
+}
+
+bool collect_types(void* context, const CJsonStreamRecord* record) {
+    StreamResult* result = (StreamResult*) context;
+    if(record->value == NULL) {
+        ++result->failures;
+        return true;
+    }
+    result->ids[result->count++] = record->value->_type;
+    return true;
+}
+
+void read_stream_in_two_chunks(const char* data, CJsonStreamFraming framing, size_t threads, size_t split, StreamResult* result) {
+    CJsonStreamReaderOptions options = cjson_stream_reader_options_default();
+    options.framing = framing;
+    options.threads = threads;
+    memset(result, 0, sizeof(StreamResult));
+    CJsonStreamReader* reader = cjson_stream_reader_new(&options, collect_ids, result);
+    ck_assert(cjson_stream_reader_feed(reader, data, split));
+    ck_assert(cjson_stream_reader_feed(reader, data + split, strlen(data) - split));
+    ck_assert(cjson_stream_reader_finish(reader));
+    ck_assert_uint_eq(cjson_stream_reader_count(reader), result->count);
+    cjson_stream_reader_free(reader);
+}
+
+void check_every_split(const char* data, CJsonStreamFraming framing, size_t threads) {
+    const double expected[] = {1, 2, 3, 4};
+    for(size_t split = 0; split <= strlen(data); ++split) {
+        StreamResult result;
+        read_stream_in_two_chunks(data, framing, threads, split, &result);
+        ck_assert_uint_eq(result.count, 4);
+        ck_assert_uint_eq(result.failures, 0);
+        ck_assert_mem_eq(result.ids, expected, sizeof(expected));
+    }
+}
+
+START_TEST(test_ndjson) {
+    check_every_split("{\"id\": 1}\n{\"id\": 2, \"s\": \"}\\n\"}\r\n\n{\"id\": 3}\n{\"id\": 4}", cjson_ndjson_framing, 1);
+    check_every_split("{\"id\": 1}\n{\"id\": 2}\n{\"id\": 3}\n{\"id\": 4}\n", cjson_ndjson_framing, 3);
+}
+
+START_TEST(test_json_seq) {
+    check_every_split("\x1e{\"id\": 1}\n\x1e{\"id\":\n 2}\n\x1e\x1e{\"id\": 3}\n\x1e{\"id\": 4}\n", cjson_json_seq_framing, 2);
+}
+
+START_TEST(test_concatenated) {
+    check_every_split("{\"id\": 1}{\"id\": 2, \"a\": [\"]\"]} {\"id\": 3}\n{\"id\": 4}", cjson_concatenated_framing, 2);
+
+    // Fed a byte at a time, documents are found whatever the chunk ends on.
+    const char data[] = "{\"id\": 1, \"s\": \"\\\\\\\"}\"}{\"id\": 2}\"x\\\"\" 7 {\"id\": 3}";
+    CJsonStreamReaderOptions options = cjson_stream_reader_options_default();
+    options.framing = cjson_concatenated_framing;
+    StreamResult result;
+    memset(&result, 0, sizeof(StreamResult));
+    CJsonStreamReader* reader = cjson_stream_reader_new(&options, collect_types, &result);
+    for(size_t i = 0; i + 1 < sizeof(data); ++i) {
+        ck_assert(cjson_stream_reader_feed(reader, data + i, 1));
+    }
+    ck_assert(cjson_stream_reader_finish(reader));
+    cjson_stream_reader_free(reader);
+    const double expected[] = {cjson_object_value, cjson_object_value, cjson_str_value, cjson_number_value, cjson_object_value};
+    ck_assert_uint_eq(result.count, 5);
+    ck_assert_uint_eq(result.failures, 0);
+    ck_assert_mem_eq(result.ids, expected, sizeof(expected));
+}
+
+START_TEST(test_malformed_record) {
+    StreamResult result;
+    read_stream_in_two_chunks("{\"id\": 1}\n{\"id\": }\n{\"id\": 3}\n", cjson_ndjson_framing, 2, 12, &result);
+    ck_assert_uint_eq(result.count, 3);
+    ck_assert_uint_eq(result.failures, 1);
+    ck_assert(result.ids[2] == 3);
+}
+
+typedef struct UnorderedResult {
+    atomic_size_t count;
+    atomic_size_t id_sum;
+} UnorderedResult;
+
+bool sum_ids(void* context, const CJsonStreamRecord* record) {
+    UnorderedResult* result = (UnorderedResult*) context;
+    const double id = *CJSON_AS_NUMBER(cjson_object_get(CJSON_AS_OBJECT(record->value), "id"));
+    atomic_fetch_add(&result->count, 1);
+    atomic_fetch_add(&result->id_sum, (size_t) id);
+    return true;
+}
+
+START_TEST(test_unordered) {
+    char data[64 * 16] = {0};
+    size_t size = 0;
+    for(size_t id = 1; id <= 64; ++id) {
+        size += sprintf(data + size, "{\"id\": %zu}\n", id);
+    }
+    CJsonStreamReaderOptions options = cjson_stream_reader_options_default();
+    options.threads = 4;
+    options.ordered = false;
+    UnorderedResult result;
+    atomic_init(&result.count, 0);
+    atomic_init(&result.id_sum, 0);
+    CJsonStreamReader* reader = cjson_stream_reader_new(&options, sum_ids, &result);
+    ck_assert(cjson_stream_reader_feed(reader, data, size));
+    ck_assert(cjson_stream_reader_finish(reader));
+    cjson_stream_reader_free(reader);
+    ck_assert_uint_eq(atomic_load(&result.count), 64);
+    ck_assert_uint_eq(atomic_load(&result.id_sum), 64 * 65 / 2);
+}
+
+bool stop_after_two(void* context, CJSON_UNUSED const CJsonStreamRecord* record) {
+    size_t* count = (size_t*) context;
+    return ++*count < 2;
+}
+
+START_TEST(test_stop) {
+    const char data[] = "1\n2\n3\n4\n";
+    size_t count = 0;
+    CJsonStreamReaderOptions options = cjson_stream_reader_options_default();
+    options.threads = 2;
+    CJsonStreamReader* reader = cjson_stream_reader_new(&options, stop_after_two, &count);
+    ck_assert(!cjson_stream_reader_feed(reader, data, strlen(data)));
+    ck_assert(!cjson_stream_reader_finish(reader));
+    cjson_stream_reader_free(reader);
+    ck_assert_uint_eq(count, 2);
+}
+
+void stream_reader_case_setup(Suite* suite) {
+    TCase* stream_reader_case = tcase_create("stream_reader");
+    suite_add_tcase(suite, stream_reader_case);
+
+    tcase_add_test(stream_reader_case, test_ndjson);
+    tcase_add_test(stream_reader_case, test_json_seq);
+    tcase_add_test(stream_reader_case, test_concatenated);
+    tcase_add_test(stream_reader_case, test_malformed_record);
+    tcase_add_test(stream_reader_case, test_unordered);
+    tcase_add_test(stream_reader_case, test_stop);
+}
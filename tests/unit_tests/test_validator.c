@@ -0,0 +1,79 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_validator.h>
+
+#include <string.h>
+
+
+size_t error_offset_of(const char* data) {
+    size_t offset = (size_t) -1;
+    ck_assert(!cjson_validate(data, strlen(data), &offset));
+    return offset;
+}
+
+START_TEST(test_validate_valid) {
+    const char* inputs[] = {
+        RAW_JSON({"key": ["value", 42, -1.5e3, null, true, false], "other": {"nested": {}}}),
+        " [ ] ",
+        "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 and a long enough tail to span a vector\"",
+        "\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\uD83D\\uDE00\"",
+        "0"
+    };
+    for(size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        ck_assert(cjson_validate(inputs[i], strlen(inputs[i]), NULL));
+    }
+}
+
+START_TEST(test_validate_error_offset) {
+    ck_assert_uint_eq(error_offset_of(""), 0);
+    ck_assert_uint_eq(error_offset_of("[1, 2"), 5);
+    ck_assert_uint_eq(error_offset_of("[1, 2,]"), 6);
+    ck_assert_uint_eq(error_offset_of("{\"a\" 1}"), 5);
+    ck_assert_uint_eq(error_offset_of("[1, 01]"), 4);
+    ck_assert_uint_eq(error_offset_of("[tru]"), 1);
+    ck_assert_uint_eq(error_offset_of("{} {}"), 3);
+    ck_assert_uint_eq(error_offset_of("[1}"), 2);
+    ck_assert_uint_eq(error_offset_of("\"abc"), 4);
+}
+
+START_TEST(test_validate_strings) {
+    // Escape sequences.
+    ck_assert_uint_eq(error_offset_of("[\"ab\\x\"]"), 4);
+    ck_assert_uint_eq(error_offset_of("[\"ab\\u12G4\"]"), 4);
+    // Control characters.
+    ck_assert_uint_eq(error_offset_of("[\"a\tb\"]"), 3);
+    // Malformed, overlong and surrogate UTF-8 sequences.
+    ck_assert_uint_eq(error_offset_of("\"a\x80\""), 2);
+    ck_assert_uint_eq(error_offset_of("\"a\xc0\xaf\""), 2);
+    ck_assert_uint_eq(error_offset_of("\"a\xed\xa0\x80\""), 2);
+    ck_assert_uint_eq(error_offset_of("\"a\xf4\x90\x80\x80\""), 2);
+    ck_assert_uint_eq(error_offset_of("\"a\xe2\x82\""), 2);
+}
+
+START_TEST(test_validate_depth) {
+    char data[2 * CJSON_VALIDATOR_MAX_DEPTH + 3];
+    memset(data, '[', CJSON_VALIDATOR_MAX_DEPTH);
+    memset(data + CJSON_VALIDATOR_MAX_DEPTH, ']', CJSON_VALIDATOR_MAX_DEPTH);
+    ck_assert(cjson_validate(data, 2 * CJSON_VALIDATOR_MAX_DEPTH, NULL));
+
+    memset(data, '[', CJSON_VALIDATOR_MAX_DEPTH + 1);
+    memset(data + CJSON_VALIDATOR_MAX_DEPTH + 1, ']', CJSON_VALIDATOR_MAX_DEPTH + 1);
+    size_t offset = 0;
+    ck_assert(!cjson_validate(data, 2 * CJSON_VALIDATOR_MAX_DEPTH + 2, &offset));
+    ck_assert_uint_eq(offset, CJSON_VALIDATOR_MAX_DEPTH);
+}
+
+void validator_case_setup(Suite* suite) {
+    TCase* validator_case = tcase_create("validator");
+    suite_add_tcase(suite, validator_case);
+
+    tcase_add_test(validator_case, test_validate_valid);
+    tcase_add_test(validator_case, test_validate_error_offset);
+    tcase_add_test(validator_case, test_validate_strings);
+    tcase_add_test(validator_case, test_validate_depth);
+}
@@ -0,0 +1,286 @@
+//
+// Created by Jean-Edouard BOULANGER on 19/10/2026.
+//
+
+#include "cases.h"
+#include "helpers.h"
+
+#include <cjson_array.h>
+#include <cjson_object.h>
+#include <cjson_reader.h>
+#include <cjson_sink.h>
+#include <cjson_str.h>
+#include <cjson_value.h>
+#include <cjson_writer.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define WRITTEN_CAPACITY 4096
+
+
+typedef struct WrittenBytes {
+    char data[WRITTEN_CAPACITY];
+    size_t size;
+    size_t writes;
+    size_t fail_after;
+} WrittenBytes;
+
+bool collect_bytes(void* context, const char* data, size_t size) {
+    WrittenBytes* written = (WrittenBytes*) context;
+    if(++written->writes == written->fail_after) { return false; }
+    ck_assert_uint_le(written->size + size, WRITTEN_CAPACITY);
+    memcpy(written->data + written->size, data, size);
+    written->size += size;
+    return true;
+}
+
+CJsonValue* make_written_value() {
+    return CJSON_ARRAY_V(
+        CJSON_OBJECT_V("key", CJSON_STR_V("a \"quoted\"\n\x01 value")),
+        CJSON_NUMBER_V(42), CJSON_NUMBER_V(-0.25), CJSON_TRUE_V, CJSON_NULL_V, CJSON_EMPTY_ARRAY_V
+    );
+}
+
+#define WRITTEN_JSON "[{\"key\":\"a \\\"quoted\\\"\\n\\u0001 value\"},42,-0.25,true,null,[]]"
+
+START_TEST(test_write_callback) {
+    CJsonValue* value = make_written_value();
+    WrittenBytes written = {.size = 0, .writes = 0, .fail_after = 0};
+    // A buffer this small is handed over many times, and strings go through unbuffered.
+    char buffer[4];
+    CJsonSink sink;
+    cjson_sink_init(&sink, collect_bytes, &written, buffer, sizeof(buffer));
+    ck_assert(cjson_write(value, &sink));
+    ck_assert_uint_gt(written.writes, 10);
+    ck_assert_uint_eq(written.size, strlen(WRITTEN_JSON));
+    ck_assert(memcmp(written.data, WRITTEN_JSON, written.size) == 0);
+
+    // Failures stick.
+    written.size = 0;
+    written.writes = 0;
+    written.fail_after = 3;
+    cjson_sink_init(&sink, collect_bytes, &written, buffer, sizeof(buffer));
+    ck_assert(!cjson_write(value, &sink));
+    ck_assert(cjson_sink_failed(&sink));
+    ck_assert_uint_eq(written.writes, 3);
+
+    char* str = cjson_to_str(value, NULL);
+    ck_assert_str_eq(str, WRITTEN_JSON);
+    free(str);
+    cjson_value_free(value);
+}
+
+START_TEST(test_write_fd_and_file) {
+    CJsonValue* value = make_written_value();
+    char read_back[WRITTEN_CAPACITY];
+
+    int pipe_fds[2];
+    ck_assert_int_eq(pipe(pipe_fds), 0);
+    CJsonSink* sink = cjson_fd_sink_new(pipe_fds[1], NULL);
+    ck_assert(cjson_write(value, sink));
+    cjson_sink_free(sink);
+    close(pipe_fds[1]);
+    const ssize_t size = read(pipe_fds[0], read_back, sizeof(read_back));
+    close(pipe_fds[0]);
+    ck_assert_int_eq(size, strlen(WRITTEN_JSON));
+    ck_assert(memcmp(read_back, WRITTEN_JSON, size) == 0);
+
+    FILE* file = tmpfile();
+    ck_assert_ptr_nonnull(file);
+    sink = cjson_file_sink_new(file, NULL);
+    ck_assert(cjson_write(value, sink));
+    cjson_sink_free(sink);
+    rewind(file);
+    ck_assert_uint_eq(fread(read_back, 1, sizeof(read_back), file), strlen(WRITTEN_JSON));
+    ck_assert(memcmp(read_back, WRITTEN_JSON, strlen(WRITTEN_JSON)) == 0);
+    fclose(file);
+
+    cjson_value_free(value);
+}
+
+START_TEST(test_write_to_buffer) {
+    CJsonValue* value = make_written_value();
+    const size_t expected_size = strlen(WRITTEN_JSON);
+    ck_assert_uint_eq(cjson_serialized_size(value, NULL), expected_size);
+
+    char buffer[WRITTEN_CAPACITY];
+    memset(buffer, '#', sizeof(buffer));
+    size_t size = 0;
+    ck_assert(cjson_write_to_buffer(value, buffer, expected_size, NULL, &size));
+    ck_assert_uint_eq(size, expected_size);
+    ck_assert(memcmp(buffer, WRITTEN_JSON, expected_size) == 0);
+    ck_assert_int_eq(buffer[expected_size], '#');
+
+    // Truncated, the output keeps what fitted and tells what was needed.
+    memset(buffer, '#', sizeof(buffer));
+    ck_assert(!cjson_write_to_buffer(value, buffer, 20, NULL, &size));
+    ck_assert_uint_eq(size, expected_size);
+    ck_assert(memcmp(buffer, WRITTEN_JSON, 20) == 0);
+    ck_assert_int_eq(buffer[20], '#');
+    ck_assert(!cjson_write_to_buffer(value, NULL, 0, NULL, NULL));
+
+    cjson_value_free(value);
+}
+
+START_TEST(test_pretty_write) {
+    CJsonValue* value = make_written_value();
+    CJsonWriteOptions options = cjson_write_options_default();
+    options.style = cjson_pretty_write_style;
+    char* str = cjson_to_str_with_options(value, &options, NULL);
+    ck_assert_str_eq(str, "[\n  {\n    \"key\": \"a \\\"quoted\\\"\\n\\u0001 value\"\n  },\n  42,\n  -0.25,\n  true,\n  null,\n  []\n]");
+    free(str);
+    cjson_value_free(value);
+
+    // Indentation deeper than the table is written in several slices.
+    const size_t depth = 100;
+    value = CJSON_NUMBER_V(1);
+    for(size_t i = 0; i < depth; ++i) {
+        value = i % 2 ? CJSON_ARRAY_V(value) : CJSON_OBJECT_V("k", value);
+    }
+    options.indent = 3;
+    str = cjson_to_str_with_options(value, &options, NULL);
+    ck_assert_uint_eq(strlen(str), cjson_serialized_size(value, &options));
+    char innermost[3 * depth + 10];
+    innermost[0] = '\n';
+    memset(innermost + 1, ' ', 3 * depth);
+    strcpy(innermost + 1 + 3 * depth, "\"k\": 1\n");
+    ck_assert_ptr_nonnull(strstr(str, innermost));
+    CJsonValue* read_back = cjson_read(str, NULL);
+    ck_assert_ptr_nonnull(read_back);
+    ck_assert(cjson_value_equals(read_back, value));
+    cjson_value_free(read_back);
+    free(str);
+    cjson_value_free(value);
+}
+
+START_TEST(test_number_format) {
+    const double numbers[] = {0, -3, 0.1, 1.0 / 3, 1e300, -1.5e-10, 9007199254740993.0, 123456789.125, -0.0001234, 99999999999999.9, 1e-5};
+    const char* expected[] = {"0", "-3", "0.1", NULL, "1e+300", "-1.5e-10", NULL, "123456789.125", "-0.0001234", "99999999999999.9", "1e-05"};
+    char out[CJSON_NUMBER_MAX_LENGTH];
+    for(size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+        const size_t size = cjson_impl_number_format(out, numbers[i]);
+        out[size] = '\0';
+        ck_assert(strtod(out, NULL) == numbers[i]);
+        if(expected[i] != NULL) {
+            ck_assert_str_eq(out, expected[i]);
+        }
+    }
+    ck_assert_uint_eq(cjson_impl_number_format(out, NAN), 4);
+    ck_assert(memcmp(out, "null", 4) == 0);
+}
+
+// Streams what make_written_value builds, its object embedded as a tree.
+bool stream_written_value(CJsonWriter* writer, const CJsonValue* object) {
+    const char key[] = "a \"quoted\"\n\x01 value";
+    return cjson_writer_begin_array(writer)
+        && (object != NULL ? cjson_writer_value(writer, object)
+            : cjson_writer_begin_object(writer) && cjson_writer_key_bytes(writer, "key", 3)
+              && cjson_writer_string_bytes(writer, key, sizeof(key) - 1) && cjson_writer_end_object(writer))
+        && cjson_writer_number(writer, 42) && cjson_writer_number(writer, -0.25)
+        && cjson_writer_bool(writer, true) && cjson_writer_null(writer)
+        && cjson_writer_begin_array(writer) && cjson_writer_end_array(writer)
+        && cjson_writer_end_array(writer) && cjson_writer_finish(writer);
+}
+
+START_TEST(test_stream_writer) {
+    CJsonValue* value = make_written_value();
+    CJsonWriteOptions options = cjson_write_options_default();
+    char buffer[WRITTEN_CAPACITY];
+    CJsonSink sink;
+    CJsonWriter writer;
+    for(int pretty = 0; pretty < 2; ++pretty) {
+        options.style = pretty ? cjson_pretty_write_style : cjson_compact_write_style;
+        char* expected = cjson_to_str_with_options(value, &options, NULL);
+        const CJsonValue* embedded[] = {NULL, cjson_array_front(cjson_value_get_array(value))};
+        for(size_t i = 0; i < 2; ++i) {
+            cjson_buffer_sink_init(&sink, buffer, sizeof(buffer));
+            cjson_writer_init(&writer, &sink, &options);
+            ck_assert(stream_written_value(&writer, embedded[i]));
+            ck_assert(!cjson_writer_failed(&writer));
+            ck_assert_uint_eq(cjson_buffer_sink_size(&sink), strlen(expected));
+            ck_assert(memcmp(buffer, expected, strlen(expected)) == 0);
+        }
+        free(expected);
+    }
+
+    // Through a small callback buffer, a failing sink fails the writer.
+    WrittenBytes written = {.size = 0, .writes = 0, .fail_after = 0};
+    char small[4];
+    cjson_sink_init(&sink, collect_bytes, &written, small, sizeof(small));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(stream_written_value(&writer, NULL));
+    ck_assert_uint_eq(written.size, strlen(WRITTEN_JSON));
+    ck_assert(memcmp(written.data, WRITTEN_JSON, written.size) == 0);
+    written = (WrittenBytes) {.size = 0, .writes = 0, .fail_after = 2};
+    cjson_sink_init(&sink, collect_bytes, &written, small, sizeof(small));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(!stream_written_value(&writer, NULL));
+    ck_assert(cjson_writer_failed(&writer));
+    cjson_value_free(value);
+}
+
+START_TEST(test_stream_writer_misuse) {
+    char buffer[64];
+    CJsonSink sink;
+    CJsonWriter writer;
+
+    cjson_buffer_sink_init(&sink, buffer, sizeof(buffer));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_array(&writer));
+    ck_assert(!cjson_writer_key(&writer, "k"));
+    ck_assert(cjson_writer_failed(&writer));
+    // Every call after a failure fails as well.
+    ck_assert(!cjson_writer_end_array(&writer));
+    ck_assert(!cjson_writer_finish(&writer));
+
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_object(&writer));
+    ck_assert(!cjson_writer_number(&writer, 1));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_object(&writer));
+    ck_assert(!cjson_writer_end_array(&writer));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_object(&writer));
+    ck_assert(cjson_writer_key(&writer, "k"));
+    ck_assert(!cjson_writer_end_object(&writer));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_object(&writer));
+    ck_assert(cjson_writer_key(&writer, "k"));
+    ck_assert(cjson_writer_null(&writer));
+    ck_assert(!cjson_writer_null(&writer));
+
+    // A single document, complete.
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(!cjson_writer_finish(&writer));
+    ck_assert(cjson_writer_number(&writer, 1));
+    ck_assert(!cjson_writer_number(&writer, 2));
+    cjson_writer_init(&writer, &sink, NULL);
+    ck_assert(cjson_writer_begin_array(&writer));
+    ck_assert(!cjson_writer_finish(&writer));
+    ck_assert(!cjson_writer_failed(&writer));
+    ck_assert(!cjson_writer_end_object(&writer));
+    ck_assert(!cjson_writer_end_array(&writer));
+
+    // Nesting is bounded.
+    cjson_writer_init(&writer, &sink, NULL);
+    for(size_t i = 0; i < CJSON_WRITER_MAX_DEPTH; ++i) {
+        cjson_writer_begin_array(&writer);
+    }
+    ck_assert(!cjson_writer_begin_array(&writer));
+}
+
+void writer_case_setup(Suite* suite) {
+    TCase* writer_case = tcase_create("writer");
+    suite_add_tcase(suite, writer_case);
+
+    tcase_add_test(writer_case, test_write_callback);
+    tcase_add_test(writer_case, test_write_fd_and_file);
+    tcase_add_test(writer_case, test_write_to_buffer);
+    tcase_add_test(writer_case, test_pretty_write);
+    tcase_add_test(writer_case, test_number_format);
+    tcase_add_test(writer_case, test_stream_writer);
+    tcase_add_test(writer_case, test_stream_writer_misuse);
+}